@@ -7,5 +7,19 @@
  */
 
 #include "lazy_winapi/clipboard.h"
+#include "lazy_winapi/clipboard_broker.h"
+#include "lazy_winapi/clipboard_cache.h"
+#include "lazy_winapi/clipboard_mem.h"
+#include "lazy_winapi/clipboard_watch.h"
+#include "lazy_winapi/dib.h"
+#include "lazy_winapi/drop.h"
 #include "lazy_winapi/error.h"
+#include "lazy_winapi/lz.h"
+#include "lazy_winapi/pattern.h"
 #include "lazy_winapi/process.h"
+#include "lazy_winapi/process_cache.h"
+#include "lazy_winapi/process_pointer.h"
+#include "lazy_winapi/process_scan.h"
+#include "lazy_winapi/process_search.h"
+#include "lazy_winapi/process_snapshot.h"
+#include "lazy_winapi/text.h"
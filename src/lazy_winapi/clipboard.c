@@ -4,67 +4,863 @@
  * Source code of @ref Clipboard module.
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <wctype.h>
+
 #include "clipboard.h"
+#include "lz.h"
+#include "text.h"
+
+/** First identifier of registered format. */
+#define FORMAT_REGISTERED_FIRST 0xC000
+/** Number of identifiers of registered formats. */
+#define FORMAT_REGISTERED_LEN (0xFFFF - FORMAT_REGISTERED_FIRST + 1)
+
+/*
+ * Win32 backend.
+ *
+ * WinAPI is invoked through wrappers so that calls are resolved at the time of call.
+ */
+static bool win32_open(HWND owner) {
+    return OpenClipboard(owner) != 0;
+}
+
+static bool win32_close() {
+    return CloseClipboard() != 0;
+}
+
+static bool win32_empty() {
+    return EmptyClipboard() != 0;
+}
+
+static HANDLE win32_get_data(UINT format) {
+    return GetClipboardData(format);
+}
+
+static HANDLE win32_set_data(UINT format, HANDLE data) {
+    return SetClipboardData(format, data);
+}
+
+static HWND win32_get_owner() {
+    return GetClipboardOwner();
+}
+
+static DWORD win32_get_seq_num() {
+    return GetClipboardSequenceNumber();
+}
+
+static UINT win32_enum_formats(UINT format) {
+    return EnumClipboardFormats(format);
+}
+
+static int win32_count_formats() {
+    return CountClipboardFormats();
+}
+
+static bool win32_is_format_avail(UINT format) {
+    return IsClipboardFormatAvailable(format) != 0;
+}
+
+static UINT win32_register_format(const wchar_t *name) {
+    return RegisterClipboardFormatW(name);
+}
+
+static int win32_get_format_name(UINT format, wchar_t *buffer, int size) {
+    return GetClipboardFormatNameW(format, buffer, size);
+}
+
+static HGLOBAL win32_global_alloc(UINT flags, size_t size) {
+    return GlobalAlloc(flags, size);
+}
+
+static void* win32_global_lock(HGLOBAL mem) {
+    return GlobalLock(mem);
+}
+
+static bool win32_global_unlock(HGLOBAL mem) {
+    return GlobalUnlock(mem) != 0;
+}
+
+static size_t win32_global_size(HGLOBAL mem) {
+    return (size_t)GlobalSize(mem);
+}
+
+static HGLOBAL win32_global_free(HGLOBAL mem) {
+    return GlobalFree(mem);
+}
+
+static HGLOBAL win32_global_realloc(HGLOBAL mem, size_t size, UINT flags) {
+    return GlobalReAlloc(mem, size, flags);
+}
+
+const Clipboard_backend Clipboard_backend_win32 = {
+    .open = win32_open,
+    .close = win32_close,
+    .empty = win32_empty,
+    .get_data = win32_get_data,
+    .set_data = win32_set_data,
+    .get_owner = win32_get_owner,
+    .get_seq_num = win32_get_seq_num,
+    .enum_formats = win32_enum_formats,
+    .count_formats = win32_count_formats,
+    .is_format_avail = win32_is_format_avail,
+    .register_format = win32_register_format,
+    .get_format_name = win32_get_format_name,
+    .global_alloc = win32_global_alloc,
+    .global_lock = win32_global_lock,
+    .global_unlock = win32_global_unlock,
+    .global_size = win32_global_size,
+    .global_free = win32_global_free,
+    .global_realloc = win32_global_realloc
+};
+
+/** Backend in use. */
+static const Clipboard_backend *backend = &Clipboard_backend_win32;
+/** Registered formats with compressed content. One bit per format. */
+static uint32_t compressed_formats[FORMAT_REGISTERED_LEN / 32];
+
+static void registry_clear();
+
+const Clipboard_backend* Clipboard_set_backend(const Clipboard_backend *new_backend) {
+    const Clipboard_backend *old_backend = backend;
+
+    backend = new_backend ? new_backend : &Clipboard_backend_win32;
+    /* Identifiers of registered formats are specific to backend. */
+    registry_clear();
+    (void)memset(compressed_formats, 0, sizeof(compressed_formats));
+    return old_backend;
+}
+
+DWORD Clipboard_get_seq_num() {
+    return backend->get_seq_num();
+}
+
+UINT Clipboard_next_avail_format() {
+    return backend->enum_formats(0);
+}
+
+UINT Clipboard_enum_formats(UINT format) {
+    return backend->enum_formats(format);
+}
+
+int Clipboard_count_avail_formats() {
+    return backend->count_formats();
+}
+
 
 bool Clipboard_open() {
-    return OpenClipboard(0);
+    return backend->open(NULL);
+}
+
+/** Number of attempts with busy waiting. */
+#define OPEN_SPIN_ATTEMPTS 16
+/** Number of attempts with yielding to other threads. */
+#define OPEN_YIELD_ATTEMPTS 16
+/** Maximum sleep between attempts in milliseconds. */
+#define OPEN_SLEEP_MAX_MS 16
+
+/** Statistics of Clipboard_open_timeout(). */
+static Clipboard_open_stats open_stats = {0};
+
+/**
+ * @return Current time in microseconds.
+ */
+static uint64_t time_now_us() {
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0) (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / (uint64_t)frequency.QuadPart;
+}
+
+/**
+ * Records time waited for clipboard into histogram.
+ */
+static void open_stats_record(uint64_t waited_us) {
+    size_t bucket = 1;
+
+    for (uint64_t limit_us = 1000; bucket < CLIPBOARD_OPEN_HISTOGRAM_LEN - 1 && waited_us >= limit_us; limit_us *= 2) {
+        bucket++;
+    }
+
+    open_stats.waited_us += waited_us;
+    open_stats.histogram[bucket]++;
+}
+
+bool Clipboard_open_timeout(DWORD timeout_ms) {
+    open_stats.calls++;
+    open_stats.attempts++;
+
+    if (backend->open(NULL)) {
+        open_stats.histogram[0]++;
+        return true;
+    }
+
+    const uint64_t start_us = time_now_us();
+    uint64_t waited_us = 0;
+    DWORD sleep_ms = 1;
+    bool result = false;
+
+    open_stats.contended++;
+
+    for (size_t attempt = 1; ; attempt++) {
+        waited_us = time_now_us() - start_us;
+
+        if (timeout_ms != INFINITE && waited_us >= (uint64_t)timeout_ms * 1000) break;
+
+        if (attempt <= OPEN_SPIN_ATTEMPTS) {
+            YieldProcessor();
+        }
+        else if (attempt <= OPEN_SPIN_ATTEMPTS + OPEN_YIELD_ATTEMPTS) {
+            (void)SwitchToThread();
+        }
+        else {
+            const DWORD remaining_ms = timeout_ms == INFINITE ? INFINITE : timeout_ms - (DWORD)(waited_us / 1000);
+
+            Sleep(sleep_ms < remaining_ms ? sleep_ms : remaining_ms);
+            if (sleep_ms < OPEN_SLEEP_MAX_MS) sleep_ms *= 2;
+        }
+
+        open_stats.attempts++;
+        if (backend->open(NULL)) {
+            result = true;
+            waited_us = time_now_us() - start_us;
+            break;
+        }
+    }
+
+    if (!result) open_stats.timeouts++;
+    open_stats_record(waited_us);
+
+    return result;
+}
+
+Clipboard_open_stats Clipboard_get_open_stats() {
+    return open_stats;
+}
+
+void Clipboard_reset_open_stats() {
+    open_stats = (Clipboard_open_stats){0};
 }
 
 bool Clipboard_close() {
-    return CloseClipboard();
+    return backend->close();
 }
 
 bool Clipboard_empty() {
-    return EmptyClipboard();
+    return backend->empty();
+}
+
+/*
+ * Compressed formats.
+ *
+ * Content is prefixed with compressed_header.
+ * Content without valid header is treated as raw, as it might be set by other application.
+ */
+
+/** Signature of compressed content: `LWZ1`. */
+#define COMPRESSED_MAGIC 0x315A574C
+/** Content is stored as it is, because it doesn't compress. */
+#define COMPRESSED_METHOD_STORE 0
+/** Content is compressed by @ref Lz module. */
+#define COMPRESSED_METHOD_LZ 1
+
+/**
+ * Header of compressed content.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t method;
+    /** Size of content before compression. */
+    uint64_t size;
+} compressed_header;
+
+bool Clipboard_set_format_compressed(UINT format, bool compressed) {
+    if (format < FORMAT_REGISTERED_FIRST) return false;
+
+    const size_t idx = format - FORMAT_REGISTERED_FIRST;
+    const uint32_t bit = (uint32_t)1 << (idx % 32);
+
+    if (compressed) compressed_formats[idx / 32] |= bit;
+    else compressed_formats[idx / 32] &= ~bit;
+    return true;
+}
+
+bool Clipboard_is_format_compressed(UINT format) {
+    if (format < FORMAT_REGISTERED_FIRST) return false;
+
+    const size_t idx = format - FORMAT_REGISTERED_FIRST;
+
+    return (compressed_formats[idx / 32] >> (idx % 32)) & 1;
+}
+
+/**
+ * Parses header of compressed content.
+ *
+ * @param[in] view Content.
+ * @param[out] header Header.
+ *
+ * @retval false If content has no valid header.
+ */
+static bool compressed_parse(const Clipboard_view *view, compressed_header *header) {
+    if (view->size < sizeof(*header)) return false;
+
+    (void)memcpy(header, view->data, sizeof(*header));
+
+    if (header->magic != COMPRESSED_MAGIC || header->size > SIZE_MAX) return false;
+
+    switch (header->method) {
+        case COMPRESSED_METHOD_STORE:
+            return view->size - sizeof(*header) == header->size;
+        case COMPRESSED_METHOD_LZ:
+            /* Size is not trusted as it is used for allocation. */
+            return header->size <= Lz_decompress_bound(view->size - sizeof(*header));
+        default:
+            return false;
+    }
+}
+
+/**
+ * Extracts content of compressed format.
+ *
+ * @param[in] view Content.
+ * @param[out] ptr Memory to hold extracted content.
+ * @param[in] size Size of ptr.
+ *
+ * @return Number of extracted bytes.
+ */
+static size_t compressed_extract(const Clipboard_view *view, uint8_t *ptr, size_t size) {
+    compressed_header header;
+
+    if (!compressed_parse(view, &header)) return Clipboard_view_read(view, 0, ptr, size);
+
+    if (size > header.size) size = (size_t)header.size;
+
+    if (header.method == COMPRESSED_METHOD_STORE) return Clipboard_view_read(view, sizeof(header), ptr, size);
+    if (size == 0) return 0;
+
+    const size_t result = Lz_decompress(view->data + sizeof(header), view->size - sizeof(header), ptr, size);
+
+    /* Content is malformed or truncated. */
+    return result == size ? result : 0;
+}
+
+/**
+ * Sets content of compressed format.
+ *
+ * Content that doesn't compress is stored as it is.
+ */
+static bool compressed_set(UINT format, const uint8_t *ptr, size_t size) {
+    compressed_header header = {
+        .magic = COMPRESSED_MAGIC,
+        .method = COMPRESSED_METHOD_LZ,
+        .size = size
+    };
+    /* Memory is shrunk by commit, so reserve only what raw content takes. */
+    uint8_t *reserved = Clipboard_reserve(format, sizeof(header) + size);
+
+    if (reserved == NULL) return false;
+
+    size_t packed_size = size > 0 ? Lz_compress(ptr, size, reserved + sizeof(header), size) : 0;
+
+    if (packed_size == 0) {
+        header.method = COMPRESSED_METHOD_STORE;
+        (void)memcpy(reserved + sizeof(header), ptr, size);
+        packed_size = size;
+    }
+
+    (void)memcpy(reserved, &header, sizeof(header));
+    return Clipboard_commit(sizeof(header) + packed_size);
 }
 
 size_t Clipboard_get_size(UINT format) {
-    const HANDLE clipboard_data = GetClipboardData(format);
+    if (Clipboard_is_format_compressed(format)) {
+        Clipboard_view view;
+        compressed_header header;
+
+        if (!Clipboard_view_acquire(format, &view)) return 0;
+
+        const size_t result = compressed_parse(&view, &header) ? (size_t)header.size : view.size;
+
+        Clipboard_view_release(&view);
+        return result;
+    }
+
+    const HANDLE clipboard_data = backend->get_data(format);
+
+    return clipboard_data ? backend->global_size(clipboard_data) : 0;
+}
+
+bool Clipboard_view_acquire(UINT format, Clipboard_view *view) {
+    const HANDLE clipboard_data = backend->get_data(format);
+
+    view->handle = NULL;
+    view->data = NULL;
+    view->size = 0;
+
+    if (clipboard_data == NULL) return false;
+
+    const uint8_t *clipboard_mem = (const uint8_t*)backend->global_lock(clipboard_data);
+
+    if (clipboard_mem == NULL) return false;
+
+    view->handle = clipboard_data;
+    view->data = clipboard_mem;
+    view->size = backend->global_size(clipboard_data);
+    return true;
+}
+
+void Clipboard_view_release(Clipboard_view *view) {
+    if (view->handle == NULL) return;
+
+    (void)backend->global_unlock(view->handle);
 
-    return clipboard_data ? (size_t)GlobalSize(clipboard_data) : 0;
+    view->handle = NULL;
+    view->data = NULL;
+    view->size = 0;
+}
+
+size_t Clipboard_view_read(const Clipboard_view *view, size_t offset, uint8_t *ptr, size_t size) {
+    if (offset >= view->size) return 0;
+
+    const size_t remaining = view->size - offset;
+    const size_t copy_size = remaining > size ? size : remaining;
+
+    (void)memcpy(ptr, view->data + offset, copy_size);
+    return copy_size;
+}
+
+size_t Clipboard_get_chunks(UINT format, size_t chunk_size, Clipboard_chunk_fn callback, void *ctx) {
+    Clipboard_view view;
+    size_t offset = 0;
+
+    if (chunk_size == 0 || !Clipboard_view_acquire(format, &view)) return 0;
+
+    while (offset < view.size) {
+        const size_t remaining = view.size - offset;
+        const size_t size = remaining > chunk_size ? chunk_size : remaining;
+
+        if (!callback(ctx, view.data + offset, size, offset)) break;
+        offset += size;
+    }
+
+    Clipboard_view_release(&view);
+    return offset;
+}
+
+bool Clipboard_drop_acquire(Clipboard_drop *drop) {
+    if (!Clipboard_view_acquire(CF_HDROP, &drop->view)) return false;
+
+    if (!Drop_iter_init(&drop->iter, drop->view.data, drop->view.size)) {
+        Clipboard_view_release(&drop->view);
+        return false;
+    }
+
+    return true;
+}
+
+void Clipboard_drop_release(Clipboard_drop *drop) {
+    Clipboard_view_release(&drop->view);
 }
 
 size_t Clipboard_get(UINT format, uint8_t *ptr, size_t size) {
-    const HANDLE clipboard_data = GetClipboardData(format);
+    Clipboard_view view;
+
+    if (!Clipboard_view_acquire(format, &view)) return 0;
+
+    const size_t copy_size = Clipboard_is_format_compressed(format) ? compressed_extract(&view, ptr, size)
+                                                                    : Clipboard_view_read(&view, 0, ptr, size);
+
+    Clipboard_view_release(&view);
+    return copy_size;
+}
+
+static void* malloc_alloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void malloc_release(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+const Clipboard_allocator Clipboard_allocator_malloc = {
+    .alloc = malloc_alloc,
+    .ctx = NULL,
+    .release = malloc_release
+};
+
+void* Clipboard_arena_alloc(void *ctx, size_t size) {
+    Clipboard_arena *arena = (Clipboard_arena*)ctx;
+    /* Keep every allocation aligned as malloc would. */
+    const size_t align = sizeof(void*) * 2;
+    const size_t offset = (arena->used + align - 1) & ~(align - 1);
+
+    if (offset > arena->capacity || arena->capacity - offset < size) return NULL;
 
-    if (clipboard_data == NULL) {
-        return 0;
+    arena->used = offset + size;
+    return arena->buffer + offset;
+}
+
+uint8_t* Clipboard_get_alloc(UINT format, const Clipboard_allocator *allocator, size_t *size) {
+    Clipboard_view view;
+    uint8_t *result = NULL;
+
+    *size = 0;
+    if (allocator == NULL) allocator = &Clipboard_allocator_malloc;
+    if (!Clipboard_view_acquire(format, &view)) return NULL;
+
+    compressed_header header;
+    const bool compressed = Clipboard_is_format_compressed(format) && compressed_parse(&view, &header);
+    const size_t content_size = compressed ? (size_t)header.size : view.size;
+
+    if (content_size > 0) result = (uint8_t*)allocator->alloc(allocator->ctx, content_size);
+
+    if (result) {
+        *size = compressed ? compressed_extract(&view, result, content_size)
+                           : Clipboard_view_read(&view, 0, result, content_size);
+
+        if (*size != content_size) {
+            if (allocator->release) allocator->release(allocator->ctx, result);
+            result = NULL;
+            *size = 0;
+        }
     }
-    else {
-        const uint8_t *clipboard_mem = (const uint8_t*)GlobalLock(clipboard_data);
 
-        if (clipboard_mem == NULL) return 0;
+    Clipboard_view_release(&view);
+    return result;
+}
+
+bool Clipboard_get_image(Clipboard_image *image, const Clipboard_allocator *allocator) {
+    Clipboard_view view;
+    Dib_info info;
+    bool result = false;
+
+    image->width = 0;
+    image->height = 0;
+    image->pixels = NULL;
+    if (allocator == NULL) allocator = &Clipboard_allocator_malloc;
 
-        const size_t clipboard_size = (size_t)GlobalSize(clipboard_data);
-        const size_t copy_size = clipboard_size > size ? size : clipboard_size;
+    if (!Clipboard_view_acquire(CF_DIBV5, &view) && !Clipboard_view_acquire(CF_DIB, &view)) return false;
 
-        (void)memcpy(ptr, clipboard_mem, copy_size);
+    if (Dib_parse(view.data, view.size, &info)) {
+        image->pixels = (uint8_t*)allocator->alloc(allocator->ctx, (size_t)info.width * info.height * 4);
+    }
 
-        (void)GlobalUnlock(clipboard_data);
-        return copy_size;
+    if (image->pixels) {
+        Dib_to_rgba(&info, view.data, image->pixels);
+        image->width = info.width;
+        image->height = info.height;
+        result = true;
     }
+
+    Clipboard_view_release(&view);
+    return result;
 }
 
-bool Clipboard_set(UINT format, const uint8_t *ptr, size_t size) {
+/**
+ * Allocates global memory and fills it with data.
+ *
+ * @return Handle to memory or NULL on failure.
+ */
+static HGLOBAL global_from_data(const uint8_t *ptr, size_t size) {
     const UINT alloc_flags = GHND;
-    const HGLOBAL alloc_handle = GlobalAlloc(alloc_flags, size);
+    const HGLOBAL alloc_handle = backend->global_alloc(alloc_flags, size);
 
-    if (alloc_handle == NULL) return false;
+    if (alloc_handle == NULL) return NULL;
 
-    uint8_t *alloc_mem = (uint8_t*)GlobalLock(alloc_handle);
+    uint8_t *alloc_mem = (uint8_t*)backend->global_lock(alloc_handle);
 
     (void)memcpy(alloc_mem, ptr, size);
-    (void)GlobalUnlock(alloc_handle);
+    (void)backend->global_unlock(alloc_handle);
+
+    return alloc_handle;
+}
+
+bool Clipboard_set(UINT format, const uint8_t *ptr, size_t size) {
+    if (Clipboard_is_format_compressed(format)) return compressed_set(format, ptr, size);
+
+    const HGLOBAL alloc_handle = global_from_data(ptr, size);
+
+    if (alloc_handle == NULL) return false;
+
+    (void)Clipboard_empty();
+
+    if (backend->set_data(format, alloc_handle) == NULL) {
+        (void)backend->global_free(alloc_handle);
+        return false;
+    }
+
+    return true;
+}
+
+/** Memory reserved by Clipboard_reserve(). */
+static struct {
+    HGLOBAL handle;
+    UINT format;
+    size_t capacity;
+} reservation = {NULL, 0, 0};
+
+uint8_t* Clipboard_reserve(UINT format, size_t capacity) {
+    if (reservation.handle != NULL) return NULL;
+
+    const HGLOBAL alloc_handle = backend->global_alloc(GHND, capacity);
+
+    if (alloc_handle == NULL) return NULL;
+
+    uint8_t *alloc_mem = (uint8_t*)backend->global_lock(alloc_handle);
+
+    if (alloc_mem == NULL) {
+        (void)backend->global_free(alloc_handle);
+        return NULL;
+    }
+
+    reservation.handle = alloc_handle;
+    reservation.format = format;
+    reservation.capacity = capacity;
+    return alloc_mem;
+}
+
+bool Clipboard_commit(size_t size) {
+    HGLOBAL alloc_handle = reservation.handle;
+
+    if (alloc_handle == NULL) return false;
+
+    reservation.handle = NULL;
+    (void)backend->global_unlock(alloc_handle);
+
+    /* GlobalReAlloc to 0 bytes discards memory, so there would be nothing to publish. */
+    if (size == 0 || size > reservation.capacity) {
+        (void)backend->global_free(alloc_handle);
+        return false;
+    }
+    else if (size < reservation.capacity) {
+        /* Consumers rely on GlobalSize so it must be exact. */
+        const HGLOBAL shrunk_handle = backend->global_realloc(alloc_handle, size, GMEM_MOVEABLE);
+
+        if (shrunk_handle == NULL) {
+            (void)backend->global_free(alloc_handle);
+            return false;
+        }
+
+        alloc_handle = shrunk_handle;
+    }
+
+    (void)Clipboard_empty();
+
+    if (backend->set_data(reservation.format, alloc_handle) == NULL) {
+        (void)backend->global_free(alloc_handle);
+        return false;
+    }
+
+    return true;
+}
+
+void Clipboard_cancel() {
+    if (reservation.handle == NULL) return;
+
+    (void)backend->global_unlock(reservation.handle);
+    (void)backend->global_free(reservation.handle);
+    reservation.handle = NULL;
+}
+
+bool Clipboard_set_many(const Clipboard_item *items, size_t len) {
+    if (len == 0) return false;
+
+    HGLOBAL *handles = (HGLOBAL*)calloc(len, sizeof(*handles));
+
+    if (handles == NULL) return false;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        handles[idx] = global_from_data(items[idx].ptr, items[idx].size);
+
+        if (handles[idx] == NULL) {
+            /* Clipboard is not touched yet so just give memory back. */
+            while (idx-- > 0) (void)backend->global_free(handles[idx]);
+            free(handles);
+            return false;
+        }
+    }
+
     (void)Clipboard_empty();
 
-    if (SetClipboardData(format, alloc_handle) == NULL) {
-        (void)GlobalFree(alloc_handle);
+    bool result = true;
+    for (size_t idx = 0; idx < len; idx++) {
+        if (backend->set_data(items[idx].format, handles[idx]) == NULL) {
+            /* Memory that is not owned by system yet must be freed by us. */
+            for (; idx < len; idx++) (void)backend->global_free(handles[idx]);
+            (void)Clipboard_empty();
+            result = false;
+            break;
+        }
+    }
+
+    free(handles);
+    return result;
+}
+
+/**
+ * Producer of delayed rendered format.
+ */
+typedef struct {
+    Clipboard_lazy_item item;
+    bool rendered;
+} lazy_entry;
+
+/** Name of window class for clipboard owner. */
+static const wchar_t LAZY_OWNER_CLASS[] = L"lazy_winapi_clipboard_owner";
+/** Clipboard owner window that receives render requests. */
+static HWND lazy_owner = NULL;
+/** Producers of currently owned formats. */
+static lazy_entry *lazy_entries = NULL;
+/** Number of producers. */
+static size_t lazy_entries_len = 0;
+
+/**
+ * Drops producers as clipboard no longer holds their formats.
+ */
+static void lazy_entries_drop() {
+    free(lazy_entries);
+    lazy_entries = NULL;
+    lazy_entries_len = 0;
+}
+
+/**
+ * Invokes producer of format and sets its result onto clipboard.
+ *
+ * @note Clipboard must be already opened either by us or by the consumer.
+ *
+ * @return Whether format was rendered.
+ */
+static bool lazy_render(UINT format) {
+    for (size_t idx = 0; idx < lazy_entries_len; idx++) {
+        lazy_entry *entry = &lazy_entries[idx];
+
+        if (entry->item.format != format || entry->rendered) continue;
+
+        Clipboard_item content = {format, NULL, 0};
+
+        if (!entry->item.producer(entry->item.ctx, &content)) return false;
+
+        const HGLOBAL alloc_handle = global_from_data(content.ptr, content.size);
+
+        if (alloc_handle == NULL) return false;
+
+        if (backend->set_data(format, alloc_handle) == NULL) {
+            (void)backend->global_free(alloc_handle);
+            return false;
+        }
+
+        entry->rendered = true;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Renders every format that is not rendered yet.
+ */
+static void lazy_render_all(HWND window) {
+    if (!backend->open(window)) return;
+
+    /* Another application might have taken clipboard already. */
+    if (backend->get_owner() == window) {
+        for (size_t idx = 0; idx < lazy_entries_len; idx++) {
+            (void)lazy_render(lazy_entries[idx].item.format);
+        }
+    }
+
+    (void)backend->close();
+}
+
+/**
+ * Window procedure of clipboard owner.
+ */
+static LRESULT CALLBACK lazy_owner_proc(HWND window, UINT msg, WPARAM wparam, LPARAM lparam) {
+    switch (msg) {
+        case WM_RENDERFORMAT:
+            (void)lazy_render((UINT)wparam);
+            return 0;
+        case WM_RENDERALLFORMATS:
+            lazy_render_all(window);
+            return 0;
+        case WM_DESTROYCLIPBOARD:
+            lazy_entries_drop();
+            return 0;
+        default:
+            return DefWindowProcW(window, msg, wparam, lparam);
+    }
+}
+
+bool Clipboard_lazy_open() {
+    if (lazy_owner == NULL) {
+        const HINSTANCE instance = GetModuleHandleW(NULL);
+        const WNDCLASSEXW window_class = {
+            .cbSize = sizeof(window_class),
+            .lpfnWndProc = lazy_owner_proc,
+            .hInstance = instance,
+            .lpszClassName = LAZY_OWNER_CLASS
+        };
+
+        (void)RegisterClassExW(&window_class);
+        lazy_owner = CreateWindowExW(0, LAZY_OWNER_CLASS, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, instance, NULL);
+
+        if (lazy_owner == NULL) return false;
+    }
+
+    return backend->open(lazy_owner);
+}
+
+bool Clipboard_set_lazy(const Clipboard_lazy_item *items, size_t len) {
+    if (len == 0 || lazy_owner == NULL) return false;
+
+    lazy_entry *entries = (lazy_entry*)malloc(len * sizeof(*entries));
+
+    if (entries == NULL) return false;
+
+    /* Makes our window owner and drops previous producers. */
+    if (!Clipboard_empty()) {
+        free(entries);
         return false;
     }
 
+    lazy_entries_drop();
+    for (size_t idx = 0; idx < len; idx++) {
+        entries[idx].item = items[idx];
+        entries[idx].rendered = false;
+    }
+    lazy_entries = entries;
+    lazy_entries_len = len;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        /* On success NULL is returned as well. */
+        SetLastError(ERROR_SUCCESS);
+        if (backend->set_data(items[idx].format, NULL) == NULL && GetLastError() != ERROR_SUCCESS) {
+            (void)Clipboard_empty();
+            return false;
+        }
+    }
+
     return true;
 }
 
+void Clipboard_lazy_destroy() {
+    if (lazy_owner == NULL) return;
+
+    /* Do not rely on WM_RENDERALLFORMATS being delivered on destruction of owner. */
+    lazy_render_all(lazy_owner);
+    (void)DestroyWindow(lazy_owner);
+    (void)UnregisterClassW(LAZY_OWNER_CLASS, GetModuleHandleW(NULL));
+    lazy_owner = NULL;
+    lazy_entries_drop();
+}
+
 bool Clipboard_set_string(const char *text) {
     const size_t text_len = strlen(text) + 1; //include newline
     return Clipboard_set(CF_TEXT, (uint8_t*)text, text_len);
@@ -75,74 +871,483 @@ bool Clipboard_set_wide_string(const wchar_t *text) {
     return Clipboard_set(CF_UNICODETEXT, (uint8_t*)text, text_len);
 }
 
-bool Clipboard_is_format_avail(UINT format) {
-    return IsClipboardFormatAvailable(format) != 0;
+bool Clipboard_set_utf8(const char *text) {
+    const size_t text_len = strlen(text);
+    const size_t wide_len = Text_utf8_to_utf16(text, text_len, NULL, 0);
+    const size_t size = (wide_len + 1) * sizeof(uint16_t);
+    uint16_t *wide_text = (uint16_t*)Clipboard_reserve(CF_UNICODETEXT, size);
+
+    if (wide_text == NULL) return false;
+
+    /* Transcode straight into clipboard memory. Null char is already there. */
+    (void)Text_utf8_to_utf16(text, text_len, wide_text, wide_len);
+    return Clipboard_commit(size);
 }
 
-UINT Clipboard_register_format(const wchar_t *name) {
-    return RegisterClipboardFormatW(name);
+size_t Clipboard_get_utf8(char *buffer, size_t size) {
+    Clipboard_view view;
+    size_t result = 0;
+
+    if (buffer != NULL && size == 0) return 0;
+    if (!Clipboard_view_acquire(CF_UNICODETEXT, &view)) return 0;
+
+    const uint16_t *wide_text = (const uint16_t*)view.data;
+    const size_t wide_size = view.size / sizeof(uint16_t);
+    size_t wide_len = 0;
+
+    while (wide_len < wide_size && wide_text[wide_len] != 0) wide_len++;
+
+    if (buffer == NULL) {
+        result = Text_utf16_to_utf8(wide_text, wide_len, NULL, 0);
+    }
+    else {
+        result = Text_utf16_to_utf8(wide_text, wide_len, buffer, size - 1);
+        buffer[result] = 0;
+    }
+
+    Clipboard_view_release(&view);
+    return result;
 }
 
 /**
- * @return Name of predefined format.
+ * Converts line endings of text.
+ *
+ * @return Number of written chars or number of required chars if dst is NULL.
  */
-static inline int format_predefined(UINT format, wchar_t* buffer, size_t size) {
-    int result = 0;
-#define CAT(_left, _right)   _left##_right
-#define FORMATTER(_name) case _name: result = swprintf(buffer, size, CAT(L, #_name)); break
-    switch (format) {
-        FORMATTER(CF_BITMAP);
-        FORMATTER(CF_DIB);
-        FORMATTER(CF_DIBV5);
-        FORMATTER(CF_DIF);
-        FORMATTER(CF_DSPBITMAP);
-        FORMATTER(CF_DSPENHMETAFILE);
-        FORMATTER(CF_DSPMETAFILEPICT);
-        FORMATTER(CF_DSPTEXT);
-        FORMATTER(CF_ENHMETAFILE);
-        FORMATTER(CF_HDROP);
-        FORMATTER(CF_LOCALE);
-        FORMATTER(CF_METAFILEPICT);
-        FORMATTER(CF_OEMTEXT);
-        FORMATTER(CF_OWNERDISPLAY);
-        FORMATTER(CF_PALETTE);
-        FORMATTER(CF_PENDATA);
-        FORMATTER(CF_RIFF);
-        FORMATTER(CF_SYLK);
-        FORMATTER(CF_TEXT);
-        FORMATTER(CF_WAVE);
-        FORMATTER(CF_TIFF);
-        FORMATTER(CF_UNICODETEXT);
+static size_t newline_convert(Clipboard_newline newline, const char *src, size_t src_len, char *dst, size_t dst_len) {
+    switch (newline) {
+        case CLIPBOARD_NEWLINE_CRLF:
+            return Text_lf_to_crlf(src, src_len, dst, dst_len);
+        case CLIPBOARD_NEWLINE_LF:
+            return Text_crlf_to_lf(src, src_len, dst, dst_len);
         default:
-            if (format >= CF_GDIOBJFIRST && format <= CF_GDIOBJLAST) {
-                result = swprintf(buffer, size, L"CF_GDIOBJ%d", format - CF_GDIOBJFIRST);
-            } else if (format >= CF_PRIVATEFIRST && format <= CF_PRIVATELAST) {
-                result = swprintf(buffer, size, L"CF_PRIVATE%d", format - CF_PRIVATEFIRST);
-            }
-            else {
-                return 0;
-            }
+            if (dst == NULL) return src_len;
+            if (src_len > dst_len) src_len = dst_len;
+            memcpy(dst, src, src_len);
+            return src_len;
     }
-#undef FORMATTER
-#undef CAT
-    /**
-     * In truncatation case null isn't appended on Win.
-     * So append by ourself and do not include null char to result.
-     */
-    if (result == -1) {
-        result = (int)size - 1;
+}
+
+/**
+ * Wide variant of newline_convert().
+ */
+static size_t newline_convert_wide(Clipboard_newline newline, const uint16_t *src, size_t src_len, uint16_t *dst, size_t dst_len) {
+    switch (newline) {
+        case CLIPBOARD_NEWLINE_CRLF:
+            return Text_lf_to_crlf_utf16(src, src_len, dst, dst_len);
+        case CLIPBOARD_NEWLINE_LF:
+            return Text_crlf_to_lf_utf16(src, src_len, dst, dst_len);
+        default:
+            if (dst == NULL) return src_len;
+            if (src_len > dst_len) src_len = dst_len;
+            memcpy(dst, src, src_len * sizeof(*dst));
+            return src_len;
+    }
+}
+
+bool Clipboard_set_string_newline(const char *text, Clipboard_newline newline) {
+    const size_t text_len = strlen(text);
+    const size_t len = newline_convert(newline, text, text_len, NULL, 0);
+    const size_t size = len + 1;
+    char *converted = (char*)Clipboard_reserve(CF_TEXT, size);
+
+    if (converted == NULL) return false;
+
+    /* Null char is already there. */
+    (void)newline_convert(newline, text, text_len, converted, len);
+    return Clipboard_commit(size);
+}
+
+bool Clipboard_set_wide_string_newline(const wchar_t *text, Clipboard_newline newline) {
+    const size_t text_len = wcslen(text);
+    const size_t len = newline_convert_wide(newline, (const uint16_t*)text, text_len, NULL, 0);
+    const size_t size = (len + 1) * sizeof(uint16_t);
+    uint16_t *converted = (uint16_t*)Clipboard_reserve(CF_UNICODETEXT, size);
+
+    if (converted == NULL) return false;
+
+    (void)newline_convert_wide(newline, (const uint16_t*)text, text_len, converted, len);
+    return Clipboard_commit(size);
+}
+
+size_t Clipboard_get_string(char *buffer, size_t size, Clipboard_newline newline) {
+    Clipboard_view view;
+    size_t result = 0;
+
+    if (buffer != NULL && size == 0) return 0;
+    if (!Clipboard_view_acquire(CF_TEXT, &view)) return 0;
+
+    const char *text = (const char*)view.data;
+    const char *text_end = (const char*)memchr(text, 0, view.size);
+    const size_t text_len = text_end ? (size_t)(text_end - text) : view.size;
+
+    if (buffer == NULL) {
+        result = newline_convert(newline, text, text_len, NULL, 0);
+    }
+    else {
+        result = newline_convert(newline, text, text_len, buffer, size - 1);
         buffer[result] = 0;
     }
+
+    Clipboard_view_release(&view);
     return result;
 }
 
+size_t Clipboard_get_wide_string(wchar_t *buffer, size_t len, Clipboard_newline newline) {
+    Clipboard_view view;
+    size_t result = 0;
+
+    if (buffer != NULL && len == 0) return 0;
+    if (!Clipboard_view_acquire(CF_UNICODETEXT, &view)) return 0;
+
+    const uint16_t *text = (const uint16_t*)view.data;
+    const size_t text_size = view.size / sizeof(uint16_t);
+    size_t text_len = 0;
+
+    while (text_len < text_size && text[text_len] != 0) text_len++;
+
+    if (buffer == NULL) {
+        result = newline_convert_wide(newline, text, text_len, NULL, 0);
+    }
+    else {
+        result = newline_convert_wide(newline, text, text_len, (uint16_t*)buffer, len - 1);
+        buffer[result] = 0;
+    }
+
+    Clipboard_view_release(&view);
+    return result;
+}
+
+bool Clipboard_is_format_avail(UINT format) {
+    return backend->is_format_avail(format);
+}
+
+/*
+ * Format registry.
+ *
+ * Names of predefined formats are in static table.
+ * Registered formats are interned on first use and can be found both by identifier and by name.
+ */
+
+/** Maximum length of format's name. Including null char. */
+#define FORMAT_NAME_LEN 256
+/**
+ * Interned format.
+ */
+typedef struct {
+    UINT format;
+    size_t name_len;
+    const wchar_t *name;
+} format_entry;
+
+#define CAT(_left, _right)   _left##_right
+#define FORMAT_ENTRY(_name) [_name] = {_name, sizeof(CAT(L, #_name)) / sizeof(wchar_t) - 1, CAT(L, #_name)}
+/** Predefined formats by identifier. */
+static const format_entry FORMAT_PREDEFINED[CF_DSPENHMETAFILE + 1] = {
+    FORMAT_ENTRY(CF_BITMAP),
+    FORMAT_ENTRY(CF_DIB),
+    FORMAT_ENTRY(CF_DIBV5),
+    FORMAT_ENTRY(CF_DIF),
+    FORMAT_ENTRY(CF_DSPBITMAP),
+    FORMAT_ENTRY(CF_DSPENHMETAFILE),
+    FORMAT_ENTRY(CF_DSPMETAFILEPICT),
+    FORMAT_ENTRY(CF_DSPTEXT),
+    FORMAT_ENTRY(CF_ENHMETAFILE),
+    FORMAT_ENTRY(CF_HDROP),
+    FORMAT_ENTRY(CF_LOCALE),
+    FORMAT_ENTRY(CF_METAFILEPICT),
+    FORMAT_ENTRY(CF_OEMTEXT),
+    FORMAT_ENTRY(CF_OWNERDISPLAY),
+    FORMAT_ENTRY(CF_PALETTE),
+    FORMAT_ENTRY(CF_PENDATA),
+    FORMAT_ENTRY(CF_RIFF),
+    FORMAT_ENTRY(CF_SYLK),
+    FORMAT_ENTRY(CF_TEXT),
+    FORMAT_ENTRY(CF_WAVE),
+    FORMAT_ENTRY(CF_TIFF),
+    FORMAT_ENTRY(CF_UNICODETEXT)
+};
+#undef FORMAT_ENTRY
+#undef CAT
+
+/** Names of CF_PRIVATE and CF_GDIOBJ ranges. Formatted on first use. */
+static wchar_t format_range_names[CF_GDIOBJLAST - CF_PRIVATEFIRST + 1][16];
+
+/** Registered formats by identifier. */
+static format_entry **registry_by_id = NULL;
+/** Open addressing table of formats by name. */
+static const format_entry **registry_by_name = NULL;
+/** Capacity of registry_by_name. Power of two. */
+static size_t registry_by_name_cap = 0;
+/** Number of formats in registry_by_name. */
+static size_t registry_by_name_len = 0;
+
+/**
+ * Case insensitive hash of name as names of formats are case insensitive.
+ */
+static size_t registry_hash(const wchar_t *name) {
+    uint32_t hash = 2166136261u;
+
+    for (; *name != 0; name++) {
+        hash ^= (uint32_t)towupper((wint_t)*name);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool registry_name_eq(const wchar_t *left, const wchar_t *right) {
+    for (; *left != 0 && *right != 0; left++, right++) {
+        if (towupper((wint_t)*left) != towupper((wint_t)*right)) return false;
+    }
+
+    return *left == *right;
+}
+
+/**
+ * @return Slot of name in registry_by_name. Either empty or holding entry with such name.
+ */
+static const format_entry** registry_name_slot(const format_entry **table, size_t cap, const wchar_t *name) {
+    size_t idx = registry_hash(name) & (cap - 1);
+
+    while (table[idx] != NULL && !registry_name_eq(table[idx]->name, name)) {
+        idx = (idx + 1) & (cap - 1);
+    }
+
+    return &table[idx];
+}
+
+/**
+ * Inserts entry into registry_by_name, growing it if necessary.
+ */
+static bool registry_name_insert(const format_entry *entry) {
+    if ((registry_by_name_len + 1) * 2 > registry_by_name_cap) {
+        const size_t new_cap = registry_by_name_cap ? registry_by_name_cap * 2 : 64;
+        const format_entry **new_table = (const format_entry**)calloc(new_cap, sizeof(*new_table));
+
+        if (new_table == NULL) return false;
+
+        for (size_t idx = 0; idx < registry_by_name_cap; idx++) {
+            if (registry_by_name[idx]) *registry_name_slot(new_table, new_cap, registry_by_name[idx]->name) = registry_by_name[idx];
+        }
+
+        free(registry_by_name);
+        registry_by_name = new_table;
+        registry_by_name_cap = new_cap;
+    }
+
+    const format_entry **slot = registry_name_slot(registry_by_name, registry_by_name_cap, entry->name);
+
+    /* Names of predefined formats take precedence over registered ones. */
+    if (*slot == NULL) {
+        *slot = entry;
+        registry_by_name_len++;
+    }
+
+    return true;
+}
+
+/**
+ * Interns registered format.
+ *
+ * @return Entry or NULL on failure.
+ */
+static const format_entry* registry_intern(UINT format, const wchar_t *name, size_t name_len) {
+    if (registry_by_id == NULL) {
+        registry_by_id = (format_entry**)calloc(FORMAT_REGISTERED_LEN, sizeof(*registry_by_id));
+
+        if (registry_by_id == NULL) return NULL;
+    }
+
+    format_entry **slot = &registry_by_id[format - FORMAT_REGISTERED_FIRST];
+
+    if (*slot) return *slot;
+
+    format_entry *entry = (format_entry*)malloc(sizeof(*entry) + (name_len + 1) * sizeof(wchar_t));
+
+    if (entry == NULL) return NULL;
+
+    wchar_t *entry_name = (wchar_t*)(entry + 1);
+    (void)memcpy(entry_name, name, (name_len + 1) * sizeof(wchar_t));
+    entry->format = format;
+    entry->name_len = name_len;
+    entry->name = entry_name;
+
+    if (!registry_name_insert(entry)) {
+        free(entry);
+        return NULL;
+    }
+
+    *slot = entry;
+    return entry;
+}
+
+/**
+ * Forgets every registered format.
+ */
+static void registry_clear() {
+    if (registry_by_id) {
+        for (size_t idx = 0; idx < FORMAT_REGISTERED_LEN; idx++) free(registry_by_id[idx]);
+    }
+
+    free(registry_by_id);
+    free(registry_by_name);
+    registry_by_id = NULL;
+    registry_by_name = NULL;
+    registry_by_name_cap = 0;
+    registry_by_name_len = 0;
+}
+
+/**
+ * @return Name of format from CF_PRIVATE or CF_GDIOBJ ranges.
+ */
+static const wchar_t* format_range_name(UINT format) {
+    wchar_t *name = format_range_names[format - CF_PRIVATEFIRST];
+
+    if (name[0] == 0) {
+        const size_t size = sizeof(format_range_names[0]) / sizeof(format_range_names[0][0]);
+
+        if (format >= CF_GDIOBJFIRST) (void)swprintf(name, size, L"CF_GDIOBJ%u", format - CF_GDIOBJFIRST);
+        else (void)swprintf(name, size, L"CF_PRIVATE%u", format - CF_PRIVATEFIRST);
+    }
+
+    return name;
+}
+
 /**
- * @return Name of user's registered format
+ * @return Identifier of format from CF_PRIVATE or CF_GDIOBJ ranges or 0.
  */
-static inline int format_custom(UINT format, wchar_t* buffer, size_t size) {
-    return GetClipboardFormatNameW(format, buffer, (int)size);
+static UINT format_range_from_name(const wchar_t *name) {
+    static const struct {
+        const wchar_t *prefix;
+        size_t prefix_len;
+        UINT first;
+        UINT last;
+    } ranges[] = {
+        {L"CF_PRIVATE", 10, CF_PRIVATEFIRST, CF_PRIVATELAST},
+        {L"CF_GDIOBJ", 9, CF_GDIOBJFIRST, CF_GDIOBJLAST}
+    };
+
+    for (size_t idx = 0; idx < sizeof(ranges) / sizeof(ranges[0]); idx++) {
+        if (wcsncmp(name, ranges[idx].prefix, ranges[idx].prefix_len) != 0) continue;
+
+        const wchar_t *digits = name + ranges[idx].prefix_len;
+        wchar_t *end = NULL;
+
+        if (*digits < L'0' || *digits > L'9') return 0;
+
+        const unsigned long offset = wcstoul(digits, &end, 10);
+
+        if (*end != 0 || offset > ranges[idx].last - ranges[idx].first) return 0;
+        return ranges[idx].first + (UINT)offset;
+    }
+
+    return 0;
+}
+
+/**
+ * Fills registry_by_name with predefined formats.
+ */
+static bool registry_init_predefined() {
+    if (registry_by_name_len > 0) return true;
+
+    for (size_t idx = 0; idx < sizeof(FORMAT_PREDEFINED) / sizeof(FORMAT_PREDEFINED[0]); idx++) {
+        if (FORMAT_PREDEFINED[idx].name && !registry_name_insert(&FORMAT_PREDEFINED[idx])) return false;
+    }
+
+    return true;
+}
+
+const wchar_t* Clipboard_format_to_name(UINT format) {
+    if (format < sizeof(FORMAT_PREDEFINED) / sizeof(FORMAT_PREDEFINED[0])) {
+        return FORMAT_PREDEFINED[format].name;
+    }
+    else if (format >= CF_PRIVATEFIRST && format <= CF_GDIOBJLAST) {
+        return format_range_name(format);
+    }
+    else if (format < FORMAT_REGISTERED_FIRST) {
+        return NULL;
+    }
+
+    if (registry_by_id && registry_by_id[format - FORMAT_REGISTERED_FIRST]) {
+        return registry_by_id[format - FORMAT_REGISTERED_FIRST]->name;
+    }
+
+    wchar_t name[FORMAT_NAME_LEN];
+    const int name_len = backend->get_format_name(format, name, FORMAT_NAME_LEN);
+
+    if (name_len <= 0 || !registry_init_predefined()) return NULL;
+
+    const format_entry *entry = registry_intern(format, name, (size_t)name_len);
+    return entry ? entry->name : NULL;
+}
+
+UINT Clipboard_format_from_name(const wchar_t *name) {
+    if (!registry_init_predefined()) return 0;
+
+    const format_entry *entry = *registry_name_slot(registry_by_name, registry_by_name_cap, name);
+
+    return entry ? entry->format : format_range_from_name(name);
+}
+
+UINT Clipboard_register_format(const wchar_t *name) {
+    const UINT format = Clipboard_format_from_name(name);
+
+    /* Only registered formats can be looked up, predefined names are registered as new formats. */
+    if (format >= FORMAT_REGISTERED_FIRST) return format;
+
+    const UINT new_format = backend->register_format(name);
+
+    if (new_format >= FORMAT_REGISTERED_FIRST) {
+        wchar_t registered_name[FORMAT_NAME_LEN];
+        /* System keeps spelling of the first registration. */
+        const int name_len = backend->get_format_name(new_format, registered_name, FORMAT_NAME_LEN);
+
+        if (name_len > 0) (void)registry_intern(new_format, registered_name, (size_t)name_len);
+    }
+
+    return new_format;
 }
 
 int Clipboard_get_format_name(UINT format, wchar_t* buffer, size_t size) {
-    return format > 0xC000 ? format_custom(format, buffer, size) : format_predefined(format, buffer, size);
+    const wchar_t *name = Clipboard_format_to_name(format);
+
+    if (name == NULL || size == 0) return 0;
+
+    size_t len = wcslen(name);
+
+    /* Truncate name by buffer and do not include null char to result. */
+    if (len >= size) len = size - 1;
+
+    (void)memcpy(buffer, name, len * sizeof(wchar_t));
+    buffer[len] = 0;
+    return (int)len;
+}
+
+size_t Clipboard_snapshot_formats(Clipboard_format_info *infos, size_t len, wchar_t *names, size_t names_len) {
+    size_t result = 0;
+    size_t names_used = 0;
+
+    for (UINT format = backend->enum_formats(0); format != 0; format = backend->enum_formats(format), result++) {
+        if (result >= len) continue;
+
+        Clipboard_format_info *info = &infos[result];
+
+        info->format = format;
+        info->size = Clipboard_get_size(format);
+        info->name = NULL;
+
+        if (names_used < names_len) {
+            wchar_t *name = names + names_used;
+            const int name_len = Clipboard_get_format_name(format, name, names_len - names_used);
+
+            /* Name must not be truncated. */
+            if (name_len > 0 && (size_t)name_len + 1 < names_len - names_used) {
+                info->name = name;
+                names_used += (size_t)name_len + 1;
+            }
+        }
+    }
+
+    return result;
 }
@@ -11,6 +11,9 @@
 
 #include <windows.h>
 
+#include "dib.h"
+#include "drop.h"
+
 /**
  * @addtogroup Clipboard
  *
@@ -28,6 +31,12 @@
  *
  * After that Clipboard cannot be opened anymore until Clipboard_close() is called.
  *
+ * ### Backend
+ *
+ * By default WinAPI is used to access clipboard.
+ * It can be replaced by Clipboard_set_backend(), for example with in-memory
+ * backend from @ref ClipboardMem that does not require desktop session.
+ *
  * Examples
  * ---------
  *
@@ -74,6 +83,24 @@
     }
  * ~~~~~~~~~~~~~~~
  *
+ * ### Scan clipboard content without copying it
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    Clipboard_view view;
+    size_t zeroes = 0;
+
+    Clipboard_open();
+    if (Clipboard_view_acquire(CF_TEXT, &view)) {
+        for (size_t idx = 0; idx < view.size; idx++) {
+            if (view.data[idx] == 0) zeroes++;
+        }
+        Clipboard_view_release(&view);
+    }
+    Clipboard_close();
+ * ~~~~~~~~~~~~~~~
+ *
  * ### Set text onto clipboard
  *
  * ~~~~~~~~~~~~~~~{.c}
@@ -101,6 +128,96 @@
     Clipboard_close();
  * ~~~~~~~~~~~~~~~
  *
+ * ### Exchange UTF-8 text with clipboard
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    char extract_text[50] = {0};
+
+    Clipboard_open();
+    Clipboard_set_utf8("For my waifu! \xE2\x9D\xA4");
+    Clipboard_get_utf8(extract_text, sizeof(extract_text));
+    Clipboard_close();
+ * ~~~~~~~~~~~~~~~
+ *
+ * ### Generate content directly in clipboard memory
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    Clipboard_open();
+    char *text = (char*)Clipboard_reserve(CF_TEXT, 64);
+    if (text) {
+        const int len = snprintf(text, 64, "Waifu number %d", 1);
+        Clipboard_commit((size_t)len + 1);
+    }
+    Clipboard_close();
+ * ~~~~~~~~~~~~~~~
+ *
+ * ### List copied files
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    Clipboard_drop drop;
+    Drop_path path;
+
+    Clipboard_open();
+    if (Clipboard_drop_acquire(&drop)) {
+        while (Drop_iter_next(&drop.iter, &path)) {
+            if (path.wide) wprintf(L"%.*ls\n", (int)path.len, (const wchar_t*)path.wide);
+            else printf("%.*s\n", (int)path.len, path.ansi);
+        }
+        Clipboard_drop_release(&drop);
+    }
+    Clipboard_close();
+ * ~~~~~~~~~~~~~~~
+ *
+ * ### Set text in multiple formats at once
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    const char text[] = "For my waifu!";
+    const wchar_t wide_text[] = L"For my waifu!";
+    const Clipboard_item items[] = {
+        {CF_TEXT, (const uint8_t*)text, sizeof(text)},
+        {CF_UNICODETEXT, (const uint8_t*)wide_text, sizeof(wide_text)}
+    };
+
+    Clipboard_open();
+    Clipboard_set_many(items, sizeof(items) / sizeof(items[0]));
+    Clipboard_close();
+ * ~~~~~~~~~~~~~~~
+ *
+ * ### Render content only when requested
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard.h"
+
+    static bool render_text(void *ctx, Clipboard_item *item) {
+        static const char text[] = "For my waifu!";
+
+        (void)ctx;
+        item->ptr = (const uint8_t*)text;
+        item->size = sizeof(text);
+        return true;
+    }
+
+    const Clipboard_lazy_item items[] = {
+        {CF_TEXT, render_text, NULL}
+    };
+
+    Clipboard_lazy_open();
+    Clipboard_set_lazy(items, sizeof(items) / sizeof(items[0]));
+    Clipboard_close();
+
+    // Process window messages...
+
+    Clipboard_lazy_destroy();
+ * ~~~~~~~~~~~~~~~
+ *
  * ### Raw set onto clipboard
  *
  * ~~~~~~~~~~~~~~~{.c}
@@ -139,11 +256,73 @@
 /*@{*/
 
 /**
- * Alias to `GetClipboardSequenceNumber()`.
+ * Clipboard backend.
+ *
+ * Every function of module accesses clipboard and its global memory through backend.
+ * Functions follow semantics of corresponding WinAPI.
+ */
+typedef struct {
+    /** `OpenClipboard()` */
+    bool (*open)(HWND owner);
+    /** `CloseClipboard()` */
+    bool (*close)();
+    /** `EmptyClipboard()` */
+    bool (*empty)();
+    /** `GetClipboardData()` */
+    HANDLE (*get_data)(UINT format);
+    /** `SetClipboardData()` */
+    HANDLE (*set_data)(UINT format, HANDLE data);
+    /** `GetClipboardOwner()` */
+    HWND (*get_owner)();
+    /** `GetClipboardSequenceNumber()` */
+    DWORD (*get_seq_num)();
+    /** `EnumClipboardFormats()` */
+    UINT (*enum_formats)(UINT format);
+    /** `CountClipboardFormats()` */
+    int (*count_formats)();
+    /** `IsClipboardFormatAvailable()` */
+    bool (*is_format_avail)(UINT format);
+    /** `RegisterClipboardFormatW()` */
+    UINT (*register_format)(const wchar_t *name);
+    /** `GetClipboardFormatNameW()` */
+    int (*get_format_name)(UINT format, wchar_t *buffer, int size);
+    /** `GlobalAlloc()` */
+    HGLOBAL (*global_alloc)(UINT flags, size_t size);
+    /** `GlobalLock()` */
+    void* (*global_lock)(HGLOBAL mem);
+    /** `GlobalUnlock()` */
+    bool (*global_unlock)(HGLOBAL mem);
+    /** `GlobalSize()` */
+    size_t (*global_size)(HGLOBAL mem);
+    /** `GlobalFree()` */
+    HGLOBAL (*global_free)(HGLOBAL mem);
+    /** `GlobalReAlloc()` */
+    HGLOBAL (*global_realloc)(HGLOBAL mem, size_t size, UINT flags);
+} Clipboard_backend;
+
+/**
+ * Backend over WinAPI. Used by default.
+ */
+extern const Clipboard_backend Clipboard_backend_win32;
+
+/**
+ * Replaces backend used by module.
+ *
+ * @warning Clipboard must not be opened and there must be no acquired views.
+ *
+ * @param[in] backend New backend. If NULL, Clipboard_backend_win32 is used.
+ *
+ * @return Previous backend.
+ */
+const Clipboard_backend* Clipboard_set_backend(const Clipboard_backend *backend);
+
+/**
+ * Retrieves clipboard sequence number.
+ *
  * @return Current value of clipboard sequence number.
  * @retval 0 If you do not have WINSTA_ACCESSCLIPBOARD access.
  */
-#define Clipboard_get_seq_num() GetClipboardSequenceNumber()
+DWORD Clipboard_get_seq_num();
 
 /**
  * Opens clipboard for use in the current thread.
@@ -153,6 +332,61 @@
  */
 bool Clipboard_open();
 
+/**
+ * Number of buckets in histogram of Clipboard_open_stats.
+ */
+#define CLIPBOARD_OPEN_HISTOGRAM_LEN 16
+
+/**
+ * Statistics of contention for clipboard collected by Clipboard_open_timeout().
+ */
+typedef struct {
+    /** Number of calls. */
+    size_t calls;
+    /** Number of calls that failed to open clipboard on first attempt. */
+    size_t contended;
+    /** Number of attempts to open clipboard. */
+    size_t attempts;
+    /** Number of calls that failed to open clipboard within timeout. */
+    size_t timeouts;
+    /** Total time in microseconds spent waiting for clipboard. */
+    uint64_t waited_us;
+    /**
+     * Number of calls by time spent waiting for clipboard.
+     *
+     * - Bucket 0 holds calls that opened clipboard on first attempt;
+     * - Bucket 1 holds calls that waited less than 1ms;
+     * - Bucket N holds calls that waited less than 2^(N-1)ms;
+     * - Last bucket holds everything above.
+     */
+    size_t histogram[CLIPBOARD_OPEN_HISTOGRAM_LEN];
+} Clipboard_open_stats;
+
+/**
+ * Opens clipboard for use in the current thread, waiting while it is opened by someone else.
+ *
+ * Attempts are retried by first spinning, then yielding to other threads
+ * and then sleeping with exponential backoff.
+ *
+ * @param[in] timeout_ms Maximum time to wait in milliseconds. `INFINITE` to wait without timeout.
+ *
+ * @retval true On success.
+ * @retval false On failure to open clipboard within timeout.
+ */
+bool Clipboard_open_timeout(DWORD timeout_ms);
+
+/**
+ * Retrieves contention statistics of Clipboard_open_timeout().
+ *
+ * @return Copy of statistics.
+ */
+Clipboard_open_stats Clipboard_get_open_stats();
+
+/**
+ * Resets contention statistics of Clipboard_open_timeout().
+ */
+void Clipboard_reset_open_stats();
+
 /**
  * Closes clipboard.
  *
@@ -177,6 +411,7 @@ bool Clipboard_empty();
  * Retrieves size in bytes of clipboard content.
  *
  * `GlobalSize` is used to determine size of content.
+ * For compressed format, size of content before compression is retrieved.
  *
  * @note Can be called only after Clipboard_open().
  *
@@ -190,6 +425,9 @@ size_t Clipboard_get_size(UINT format);
 /**
  * Gets clipboard content of specific format.
  *
+ * Content of compressed format is decompressed.
+ * Compressed content that is malformed or truncated is treated as failure.
+ *
  * @note Can be called only after Clipboard_open().
  *
  * @param[in] format Format of clipboard to retrieve.
@@ -202,9 +440,234 @@ size_t Clipboard_get_size(UINT format);
  */
 size_t Clipboard_get(UINT format, uint8_t *ptr, size_t size);
 
+/**
+ * Borrowed view into clipboard content.
+ *
+ * Filled by Clipboard_view_acquire() and valid until Clipboard_view_release().
+ */
+typedef struct {
+    /** Clipboard memory handle that is kept locked. */
+    HANDLE handle;
+    /** Content of clipboard. */
+    const uint8_t *data;
+    /** Size of content in bytes. */
+    size_t size;
+} Clipboard_view;
+
+/**
+ * Acquires view into clipboard content of specific format without copying it.
+ *
+ * Memory stays locked until Clipboard_view_release() is called.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @warning View must be released before Clipboard_close().
+ *
+ * @param[in] format Format of clipboard to retrieve.
+ * @param[out] view View to fill. Reset to empty on failure.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_view_acquire(UINT format, Clipboard_view *view);
+
+/**
+ * Releases view acquired by Clipboard_view_acquire().
+ *
+ * Releasing empty view does nothing.
+ *
+ * @param[in,out] view View to release. Reset to empty.
+ */
+void Clipboard_view_release(Clipboard_view *view);
+
+/**
+ * Copies part of viewed content.
+ *
+ * @param[in] view Acquired view.
+ * @param[in] offset Offset in content to read from.
+ * @param[out] ptr Memory to hold content.
+ * @param[in] size Number of bytes to read. Truncated by the end of content.
+ *
+ * @return Number of copied bytes.
+ * @retval 0 If offset is beyond the end of content.
+ */
+size_t Clipboard_view_read(const Clipboard_view *view, size_t offset, uint8_t *ptr, size_t size);
+
+/**
+ * Callback that receives chunk of clipboard content.
+ *
+ * @param[in] ctx User's context from Clipboard_get_chunks().
+ * @param[in] chunk Chunk of content. Points directly into clipboard memory.
+ * @param[in] size Size of chunk.
+ * @param[in] offset Offset of chunk in content.
+ *
+ * @retval true To continue with the next chunk.
+ * @retval false To stop.
+ */
+typedef bool (*Clipboard_chunk_fn)(void *ctx, const uint8_t *chunk, size_t size, size_t offset);
+
+/**
+ * Streams clipboard content of specific format by chunks.
+ *
+ * Clipboard memory is locked once and each chunk is passed to callback without copying.
+ * Every chunk except the last one has size of `chunk_size`.
+ *
+ * @note Can be called only after Clipboard_open().
+ *
+ * @param[in] format Format of clipboard to retrieve.
+ * @param[in] chunk_size Maximum size of chunk. Cannot be 0.
+ * @param[in] callback Callback to receive chunks.
+ * @param[in] ctx User's context to pass into callback.
+ *
+ * @return Number of bytes passed to callback.
+ * @retval 0 On failure.
+ */
+size_t Clipboard_get_chunks(UINT format, size_t chunk_size, Clipboard_chunk_fn callback, void *ctx);
+
+/**
+ * File list of format CF_HDROP, iterated within clipboard memory.
+ *
+ * Filled by Clipboard_drop_acquire() and valid until Clipboard_drop_release().
+ */
+typedef struct {
+    /** Clipboard memory. */
+    Clipboard_view view;
+    /** Iterator over paths. Advance it with Drop_iter_next(). */
+    Drop_iter iter;
+} Clipboard_drop;
+
+/**
+ * Locks clipboard content of format CF_HDROP to iterate over its paths in place.
+ *
+ * Both ANSI and wide lists are supported.
+ * Yielded paths point directly into clipboard memory.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Drop module.
+ *
+ * @param[out] drop File list. Must be released with Clipboard_drop_release() on success.
+ *
+ * @retval true On success.
+ * @retval false If there is no file list or it is malformed.
+ */
+bool Clipboard_drop_acquire(Clipboard_drop *drop);
+
+/**
+ * Unlocks file list locked by Clipboard_drop_acquire().
+ *
+ * @param[in] drop File list.
+ */
+void Clipboard_drop_release(Clipboard_drop *drop);
+
+/**
+ * Memory allocator for Clipboard_get_alloc().
+ */
+typedef struct {
+    /**
+     * Allocates memory.
+     *
+     * @param[in] ctx Allocator's context.
+     * @param[in] size Number of bytes to allocate.
+     *
+     * @return Allocated memory or NULL on failure.
+     */
+    void* (*alloc)(void *ctx, size_t size);
+    /** Allocator's context. */
+    void *ctx;
+    /**
+     * Frees memory that cannot be returned to caller, because content turned out to be malformed.
+     *
+     * Can be NULL, if allocator doesn't free memory individually.
+     *
+     * @param[in] ctx Allocator's context.
+     * @param[in] ptr Memory returned by alloc.
+     */
+    void (*release)(void *ctx, void *ptr);
+} Clipboard_allocator;
+
+/**
+ * Allocator over `malloc`. Memory must be freed by `free`.
+ */
+extern const Clipboard_allocator Clipboard_allocator_malloc;
+
+/**
+ * Bump arena over user's buffer.
+ *
+ * Allocations are never freed individually. Set `used` to 0 to reuse the whole buffer.
+ */
+typedef struct {
+    /** Memory to allocate from. */
+    uint8_t *buffer;
+    /** Size of buffer. */
+    size_t capacity;
+    /** Number of used bytes. */
+    size_t used;
+} Clipboard_arena;
+
+/**
+ * Allocates memory from Clipboard_arena.
+ *
+ * To be used as `Clipboard_allocator{Clipboard_arena_alloc, &arena}`.
+ *
+ * @param[in] ctx Pointer to Clipboard_arena.
+ * @param[in] size Number of bytes to allocate.
+ *
+ * @return Allocated memory.
+ * @retval NULL If arena has not enough space.
+ */
+void* Clipboard_arena_alloc(void *ctx, size_t size);
+
+/**
+ * Gets clipboard content of specific format into newly allocated memory.
+ *
+ * Clipboard memory is locked only once to determine size and to copy content.
+ * Content of compressed format is decompressed.
+ * If compressed content is malformed or truncated, memory is given back through Clipboard_allocator::release.
+ *
+ * @note Can be called only after Clipboard_open().
+ *
+ * @param[in] format Format of clipboard to retrieve.
+ * @param[in] allocator Allocator of memory. If NULL, Clipboard_allocator_malloc is used.
+ * @param[out] size Size of content in bytes.
+ *
+ * @return Memory with content. Caller is responsible to free it according to allocator.
+ * @retval NULL On failure or if there is no content.
+ */
+uint8_t* Clipboard_get_alloc(UINT format, const Clipboard_allocator *allocator, size_t *size);
+
+/**
+ * Image in top-down RGBA.
+ */
+typedef struct {
+    /** Width in pixels. */
+    uint32_t width;
+    /** Height in pixels. */
+    uint32_t height;
+    /** Pixels, `width * 4` bytes per row. Allocated by allocator of Clipboard_get_image(). */
+    uint8_t *pixels;
+} Clipboard_image;
+
+/**
+ * Gets clipboard image as top-down RGBA.
+ *
+ * Format CF_DIBV5 is preferred over CF_DIB to keep alpha channel.
+ * Pixels are converted in single pass straight from clipboard memory.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Dib module.
+ *
+ * @param[out] image Image.
+ * @param[in] allocator Allocator of pixels. If NULL, Clipboard_allocator_malloc is used.
+ *
+ * @retval true On success.
+ * @retval false If there is no image, its layout is unsupported or memory cannot be allocated.
+ */
+bool Clipboard_get_image(Clipboard_image *image, const Clipboard_allocator *allocator);
+
 /**
  * Sets clipboard content of specific format.
  *
+ * Content of compressed format is compressed.
+ *
  * @note Can be called only after Clipboard_open().
  *
  * @param[in] format Format of clipboard to retrieve.
@@ -216,6 +679,136 @@ size_t Clipboard_get(UINT format, uint8_t *ptr, size_t size);
  */
 bool Clipboard_set(UINT format, const uint8_t *ptr, size_t size);
 
+/**
+ * Reserves clipboard memory to be filled in place.
+ *
+ * Memory is published by Clipboard_commit() or given back by Clipboard_cancel().
+ * Only one reservation can exist at a time.
+ *
+ * @note Can be called only after Clipboard_open().
+ *
+ * @param[in] format Format of content.
+ * @param[in] capacity Maximum size of content.
+ *
+ * @return Writable memory of capacity size. Zero initialized.
+ * @retval NULL On failure or if there is reservation already.
+ */
+uint8_t* Clipboard_reserve(UINT format, size_t capacity);
+
+/**
+ * Publishes memory reserved by Clipboard_reserve() as clipboard content.
+ *
+ * If size is less than capacity, memory is shrunk before publishing.
+ * Clipboard is emptied before publishing, as with Clipboard_set().
+ * Reservation ends regardless of result.
+ *
+ * @param[in] size Actual size of content. Cannot be 0 or exceed capacity.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_commit(size_t size);
+
+/**
+ * Gives back memory reserved by Clipboard_reserve() without publishing it.
+ */
+void Clipboard_cancel();
+
+/**
+ * Clipboard content of one format for Clipboard_set_many().
+ */
+typedef struct {
+    /** Format of content. */
+    UINT format;
+    /** Data to set. */
+    const uint8_t *ptr;
+    /** Size of data to set. */
+    size_t size;
+} Clipboard_item;
+
+/**
+ * Sets clipboard content of multiple formats at once.
+ *
+ * Memory for every item is allocated before clipboard is emptied.
+ * So if any allocation fails, clipboard content is left untouched.
+ * Otherwise clipboard is emptied only once and all items are set.
+ *
+ * @note Can be called only after Clipboard_open().
+ *
+ * @param[in] items Content to set.
+ * @param[in] len Number of items.
+ *
+ * @retval true On success.
+ * @retval false On failure. If failure happens after clipboard is emptied, it is left empty.
+ */
+bool Clipboard_set_many(const Clipboard_item *items, size_t len);
+
+/**
+ * Producer of delayed rendered clipboard content.
+ *
+ * Content is copied onto clipboard right after producer returns.
+ *
+ * @param[in] ctx User's context from Clipboard_lazy_item.
+ * @param[in,out] item Content to set. Format is already filled.
+ *
+ * @retval true If item is filled with content.
+ * @retval false On failure.
+ */
+typedef bool (*Clipboard_producer)(void *ctx, Clipboard_item *item);
+
+/**
+ * Delayed rendered format for Clipboard_set_lazy().
+ */
+typedef struct {
+    /** Format of content. */
+    UINT format;
+    /** Producer of content. */
+    Clipboard_producer producer;
+    /** User's context to pass into producer. */
+    void *ctx;
+} Clipboard_lazy_item;
+
+/**
+ * Opens clipboard for use in the current thread with hidden owner window.
+ *
+ * Owner window is created on first call and is required by Clipboard_set_lazy().
+ *
+ * @note Owner window belongs to the current thread, which must process window messages
+ *       for other applications to receive delayed rendered content.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_lazy_open();
+
+/**
+ * Sets formats onto clipboard without rendering their content.
+ *
+ * Clipboard is emptied once and each format is set with `SetClipboardData(format, NULL)`.
+ * Producer is invoked only when some application requests its format,
+ * or when owner window is destroyed by Clipboard_lazy_destroy().
+ *
+ * Producers are dropped once clipboard is emptied by anyone.
+ *
+ * @note Can be called only after Clipboard_lazy_open().
+ *
+ * @param[in] items Formats to set.
+ * @param[in] len Number of items.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_set_lazy(const Clipboard_lazy_item *items, size_t len);
+
+/**
+ * Destroys owner window created by Clipboard_lazy_open().
+ *
+ * If clipboard is still owned by it, every format that is not rendered yet gets rendered.
+ *
+ * @note Clipboard must not be opened.
+ */
+void Clipboard_lazy_destroy();
+
 /**
  * Sets string onto clipboard as format CF_UNICODETEXT.
  *
@@ -241,13 +834,133 @@ bool Clipboard_set_wide_string(const wchar_t *text);
 bool Clipboard_set_string(const char *text);
 
 /**
- * Alias to `EnumClipboardFormats(0)`.
+ * Sets UTF-8 string onto clipboard as format CF_UNICODETEXT.
+ *
+ * String is transcoded straight into clipboard memory.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[in] text UTF-8 string to set. Invalid sequences are replaced with U+FFFD.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_set_utf8(const char *text);
+
+/**
+ * Gets clipboard text of format CF_UNICODETEXT as UTF-8 string.
+ *
+ * Text is transcoded straight from clipboard memory.
+ *
  * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[out] buffer Memory to hold string. If NULL, only required length is calculated.
+ * @param[in] size Size of buffer. Including null char.
+ *                 String is truncated by it without splitting code points.
+ *
+ * @return Number of written bytes. Excluding null char.
+ *         If buffer is NULL, number of bytes required to hold whole text. Excluding null char.
+ * @retval 0 On failure.
+ */
+size_t Clipboard_get_utf8(char *buffer, size_t size);
+
+/**
+ * Line endings of text.
+ */
+typedef enum {
+    /** Line endings are kept as they are. */
+    CLIPBOARD_NEWLINE_KEEP,
+    /** Bare LF is converted into CRLF. */
+    CLIPBOARD_NEWLINE_CRLF,
+    /** CRLF is converted into LF. */
+    CLIPBOARD_NEWLINE_LF
+} Clipboard_newline;
+
+/**
+ * Sets string onto clipboard as format CF_TEXT, converting its line endings.
+ *
+ * Converted string is written straight into clipboard memory.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[in] text String to set.
+ * @param[in] newline Line endings of clipboard text.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_set_string_newline(const char *text, Clipboard_newline newline);
+
+/**
+ * Sets wide string onto clipboard as format CF_UNICODETEXT, converting its line endings.
+ *
+ * Converted string is written straight into clipboard memory.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[in] text Unicode string to set.
+ * @param[in] newline Line endings of clipboard text.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_set_wide_string_newline(const wchar_t *text, Clipboard_newline newline);
+
+/**
+ * Gets clipboard text of format CF_TEXT, converting its line endings.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[out] buffer Memory to hold string. If NULL, only required length is calculated.
+ * @param[in] size Size of buffer. Including null char.
+ * @param[in] newline Line endings of result.
+ *
+ * @return Number of written chars. Excluding null char.
+ *         If buffer is NULL, number of chars required to hold whole text. Excluding null char.
+ * @retval 0 On failure.
+ */
+size_t Clipboard_get_string(char *buffer, size_t size, Clipboard_newline newline);
+
+/**
+ * Gets clipboard text of format CF_UNICODETEXT, converting its line endings.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Requires @ref Text module.
+ *
+ * @param[out] buffer Memory to hold string. If NULL, only required length is calculated.
+ * @param[in] len Length of buffer in wide chars. Including null char.
+ * @param[in] newline Line endings of result.
+ *
+ * @return Number of written wide chars. Excluding null char.
+ *         If buffer is NULL, number of wide chars required to hold whole text. Excluding null char.
+ * @retval 0 On failure.
+ */
+size_t Clipboard_get_wide_string(wchar_t *buffer, size_t len, Clipboard_newline newline);
+
+/**
+ * Retrieves first available clipboard format as `EnumClipboardFormats(0)`.
+ * @note Can be called only after Clipboard_open().
+ *
+ * @return Next available clipboard format.
+ * @retval 0 On failure or if there is no more formats.
+ */
+UINT Clipboard_next_avail_format();
+
+/**
+ * Retrieves clipboard format that is available after specified one as `EnumClipboardFormats()`.
+ * @note Can be called only after Clipboard_open().
+ *
+ * @param[in] format Clipboard format identifier. If 0, the first available format is retrieved.
  *
  * @return Next available clipboard format.
  * @retval 0 On failure or if there is no more formats.
  */
-#define Clipboard_next_avail_format() EnumClipboardFormats(0)
+UINT Clipboard_enum_formats(UINT format);
 
 /**
  * @param[in] format Clipboard format identifier.
@@ -257,15 +970,16 @@ bool Clipboard_set_string(const char *text);
 bool Clipboard_is_format_avail(UINT format);
 
 /**
- * Alias to `CountClipboardFormats()`.
+ * Retrieves number of formats as `CountClipboardFormats()`.
  * @return Number of formats currently available on clipboard.
  */
-#define Clipboard_count_avail_formats() CountClipboardFormats()
+int Clipboard_count_avail_formats();
 
 /**
  * Registers new clipboard format.
  *
  * If format with such name already exists, its identifier is returned.
+ * Registered formats are cached, so subsequent calls with the same name do not access backend.
  *
  * @param[in] name New format's name.
  *
@@ -286,4 +1000,87 @@ UINT Clipboard_register_format(const wchar_t *name);
  */
 int Clipboard_get_format_name(UINT format, wchar_t* buffer, size_t size);
 
+/**
+ * Retrieves interned name of clipboard format.
+ *
+ * Names of predefined formats are static. Names of registered formats are
+ * retrieved from backend on first use and cached until backend is replaced.
+ *
+ * @param[in] format Format identifier.
+ *
+ * @return Name of format. Valid until backend is replaced.
+ * @retval NULL If format is unknown.
+ */
+const wchar_t* Clipboard_format_to_name(UINT format);
+
+/**
+ * Looks up clipboard format by name without registering it.
+ *
+ * Names are case insensitive.
+ * Registered format can be found only after it is cached by Clipboard_register_format()
+ * or Clipboard_format_to_name().
+ *
+ * @param[in] name Name of format.
+ *
+ * @return Identifier of format.
+ * @retval 0 If format is unknown.
+ */
+UINT Clipboard_format_from_name(const wchar_t *name);
+
+/**
+ * Sets whether content of registered format is compressed.
+ *
+ * Content of compressed format is stored with small header, and compressed by @ref Lz module
+ * unless it doesn't compress.
+ * Clipboard_set() compresses content, while Clipboard_get(), Clipboard_get_size()
+ * and Clipboard_get_alloc() work with content as it was before compression.
+ * Content without header, as set by other applications, is read as it is.
+ *
+ * Views, chunks and other setters work with stored content.
+ * Every application that reads format must treat it as compressed.
+ * Flags are reset when backend is replaced.
+ *
+ * @note Requires @ref Lz module.
+ *
+ * @param[in] format Registered format identifier.
+ * @param[in] compressed Whether content is compressed.
+ *
+ * @retval true On success.
+ * @retval false If format is not registered one.
+ */
+bool Clipboard_set_format_compressed(UINT format, bool compressed);
+
+/**
+ * @return Whether content of format is compressed.
+ */
+bool Clipboard_is_format_compressed(UINT format);
+
+/**
+ * Information about format on clipboard.
+ */
+typedef struct {
+    /** Format identifier. */
+    UINT format;
+    /** Size of content in bytes as Clipboard_get_size(). */
+    size_t size;
+    /** Name of format. NULL if it is unknown or does not fit into buffer. */
+    const wchar_t *name;
+} Clipboard_format_info;
+
+/**
+ * Retrieves information about every format on clipboard at once.
+ *
+ * @note Can be called only after Clipboard_open().
+ * @note Content of delayed rendered formats gets rendered to determine its size.
+ *
+ * @param[out] infos Memory to hold information. Formats in excess of len are only counted.
+ * @param[in] len Number of elements in infos.
+ * @param[out] names Memory to hold names of formats. Can be NULL.
+ * @param[in] names_len Number of characters in names.
+ *
+ * @return Number of formats on clipboard.
+ * @retval 0 On failure or if clipboard is empty.
+ */
+size_t Clipboard_snapshot_formats(Clipboard_format_info *infos, size_t len, wchar_t *names, size_t names_len);
+
 /*@}*/
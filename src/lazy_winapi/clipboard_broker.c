@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * Source code of @ref ClipboardBroker module.
+ */
+
+#include <stdlib.h>
+
+#include "clipboard.h"
+#include "clipboard_broker.h"
+
+struct Clipboard_broker {
+    /** Broker's thread. */
+    HANDLE thread;
+    /** Signaled when requests are submitted into empty queue or broker is stopping. */
+    HANDLE wake;
+    DWORD open_timeout_ms;
+    volatile LONG stopping;
+
+    /** Submitted requests, the most recent first. */
+    Clipboard_request *volatile queue;
+
+    /** Guards completion of requests and stats. */
+    CRITICAL_SECTION lock;
+    /** Signaled when batch of requests is complete. */
+    CONDITION_VARIABLE completed;
+    Clipboard_broker_stats stats;
+};
+
+/**
+ * Executes request while clipboard is opened.
+ */
+static size_t broker_execute(Clipboard_request *request) {
+    switch (request->type) {
+        case CLIPBOARD_REQUEST_GET:
+            return Clipboard_get(request->format, request->data, request->size);
+        case CLIPBOARD_REQUEST_GET_SIZE:
+            return Clipboard_get_size(request->format);
+        case CLIPBOARD_REQUEST_SET:
+            return Clipboard_set(request->format, request->data, request->size) ? 1 : 0;
+        case CLIPBOARD_REQUEST_FORMATS: {
+            size_t result = 0;
+
+            for (UINT format = Clipboard_enum_formats(0); format != 0; format = Clipboard_enum_formats(format), result++) {
+                if (result < request->size) request->formats[result] = format;
+            }
+
+            return result;
+        }
+        case CLIPBOARD_REQUEST_CALL:
+            return request->fn(request->ctx);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Executes every queued request under single open of clipboard.
+ *
+ * @return Whether there were requests.
+ */
+static bool broker_drain(Clipboard_broker *broker) {
+    /* Whole queue is taken at once, so producers never contend with broker for single request. */
+    Clipboard_request *request = (Clipboard_request*)InterlockedExchangePointer((PVOID volatile*)&broker->queue, NULL);
+    Clipboard_request *batch = NULL;
+    size_t len = 0;
+
+    if (request == NULL) return false;
+
+    /* Restore order of submission. */
+    while (request) {
+        Clipboard_request *next = request->next;
+
+        request->next = batch;
+        batch = request;
+        request = next;
+        len++;
+    }
+
+    const bool opened = Clipboard_open_timeout(broker->open_timeout_ms);
+
+    for (request = batch; request; request = request->next) {
+        request->result = opened ? broker_execute(request) : 0;
+    }
+
+    if (opened) (void)Clipboard_close();
+
+    EnterCriticalSection(&broker->lock);
+    broker->stats.requests += len;
+    if (opened) broker->stats.batches++;
+    /* Request can be freed by its owner as soon as it is done. */
+    for (request = batch; request; request = batch) {
+        batch = request->next;
+        request->done = 1;
+    }
+    LeaveCriticalSection(&broker->lock);
+    WakeAllConditionVariable(&broker->completed);
+
+    return true;
+}
+
+/**
+ * Broker's thread.
+ */
+static DWORD WINAPI broker_thread(LPVOID param) {
+    Clipboard_broker *broker = (Clipboard_broker*)param;
+
+    while (!broker->stopping) {
+        (void)WaitForSingleObject(broker->wake, INFINITE);
+
+        while (broker_drain(broker));
+    }
+
+    /* Requests that raced with stop. */
+    while (broker_drain(broker));
+    return 0;
+}
+
+Clipboard_broker* Clipboard_broker_start(DWORD open_timeout_ms) {
+    Clipboard_broker *broker = (Clipboard_broker*)calloc(1, sizeof(*broker));
+
+    if (broker == NULL) return NULL;
+
+    broker->open_timeout_ms = open_timeout_ms;
+    InitializeCriticalSection(&broker->lock);
+    InitializeConditionVariable(&broker->completed);
+
+    broker->wake = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (broker->wake != NULL) {
+        broker->thread = CreateThread(NULL, 0, broker_thread, broker, 0, NULL);
+
+        if (broker->thread != NULL) return broker;
+
+        (void)CloseHandle(broker->wake);
+    }
+
+    DeleteCriticalSection(&broker->lock);
+    free(broker);
+    return NULL;
+}
+
+void Clipboard_broker_stop(Clipboard_broker *broker) {
+    (void)InterlockedExchange(&broker->stopping, 1);
+    (void)SetEvent(broker->wake);
+    (void)WaitForSingleObject(broker->thread, INFINITE);
+
+    (void)CloseHandle(broker->thread);
+    (void)CloseHandle(broker->wake);
+    DeleteCriticalSection(&broker->lock);
+    free(broker);
+}
+
+void Clipboard_broker_submit(Clipboard_broker *broker, Clipboard_request *request) {
+    Clipboard_request *head;
+
+    request->result = 0;
+    request->done = 0;
+
+    do {
+        head = broker->queue;
+        request->next = head;
+    } while (InterlockedCompareExchangePointer((PVOID volatile*)&broker->queue, request, head) != head);
+
+    /* Broker drains whole queue once woken, so only the first request needs to wake it. */
+    if (head == NULL) (void)SetEvent(broker->wake);
+}
+
+size_t Clipboard_broker_wait(Clipboard_broker *broker, Clipboard_request *request) {
+    EnterCriticalSection(&broker->lock);
+    while (!request->done) {
+        (void)SleepConditionVariableCS(&broker->completed, &broker->lock, INFINITE);
+    }
+    LeaveCriticalSection(&broker->lock);
+
+    return request->result;
+}
+
+size_t Clipboard_broker_call(Clipboard_broker *broker, Clipboard_request *request) {
+    Clipboard_broker_submit(broker, request);
+    return Clipboard_broker_wait(broker, request);
+}
+
+Clipboard_broker_stats Clipboard_broker_get_stats(Clipboard_broker *broker) {
+    Clipboard_broker_stats stats;
+
+    EnterCriticalSection(&broker->lock);
+    stats = broker->stats;
+    LeaveCriticalSection(&broker->lock);
+
+    return stats;
+}
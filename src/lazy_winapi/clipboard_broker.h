@@ -0,0 +1,184 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ClipboardBroker module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+/**
+ * @addtogroup ClipboardBroker
+ *
+ * Thread-safe access to clipboard through single owner thread.
+ *
+ * Broker owns dedicated thread that is the only one to use @ref Clipboard module.
+ * Other threads submit requests into lock-free queue, and broker executes
+ * every request that is queued by the time it wakes up under single
+ * Clipboard_open() and Clipboard_close() pair.
+ *
+ * Requests are owned by caller and must stay valid until they are complete.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Read text from worker threads
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard_broker.h"
+
+    Clipboard_broker *broker = Clipboard_broker_start(100);
+
+    // On any thread
+    char text[256];
+    Clipboard_request request = {
+        .type = CLIPBOARD_REQUEST_GET,
+        .format = CF_TEXT,
+        .data = (uint8_t*)text,
+        .size = sizeof(text)
+    };
+    Clipboard_broker_call(broker, &request);
+
+    Clipboard_broker_stop(broker);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Kind of request.
+ */
+typedef enum {
+    /** Clipboard_get() into data of size. */
+    CLIPBOARD_REQUEST_GET,
+    /** Clipboard_get_size() of format. */
+    CLIPBOARD_REQUEST_GET_SIZE,
+    /** Clipboard_set() of data of size. */
+    CLIPBOARD_REQUEST_SET,
+    /** Enumeration of available formats into formats of size. */
+    CLIPBOARD_REQUEST_FORMATS,
+    /** Invocation of callback while clipboard is opened. */
+    CLIPBOARD_REQUEST_CALL
+} Clipboard_request_type;
+
+/**
+ * Callback of CLIPBOARD_REQUEST_CALL.
+ *
+ * Invoked on broker's thread while clipboard is opened.
+ *
+ * @param[in] ctx User's context from request.
+ *
+ * @return Result of request.
+ */
+typedef size_t (*Clipboard_request_fn)(void *ctx);
+
+/**
+ * Request to broker.
+ */
+typedef struct Clipboard_request {
+    Clipboard_request_type type;
+    /** Format of clipboard content. */
+    UINT format;
+    /** Memory to get content into or content to set. */
+    uint8_t *data;
+    /** Size of data or length of formats. */
+    size_t size;
+    /** Memory to enumerate formats into. */
+    UINT *formats;
+    /** Callback of CLIPBOARD_REQUEST_CALL. */
+    Clipboard_request_fn fn;
+    /** User's context of callback. */
+    void *ctx;
+
+    /**
+     * Result of request:
+     * - Number of copied bytes for CLIPBOARD_REQUEST_GET;
+     * - Size of content for CLIPBOARD_REQUEST_GET_SIZE;
+     * - 1 on success for CLIPBOARD_REQUEST_SET;
+     * - Number of available formats for CLIPBOARD_REQUEST_FORMATS;
+     * - Result of callback for CLIPBOARD_REQUEST_CALL.
+     *
+     * 0 if clipboard cannot be opened.
+     */
+    size_t result;
+
+    /** Next request in queue. Used by broker. */
+    struct Clipboard_request *next;
+    /** Whether request is complete. Used by broker. */
+    volatile LONG done;
+} Clipboard_request;
+
+/**
+ * Broker statistics.
+ */
+typedef struct {
+    /** Number of executed requests. */
+    size_t requests;
+    /** Number of times clipboard was opened to execute requests. */
+    size_t batches;
+} Clipboard_broker_stats;
+
+/**
+ * Clipboard broker.
+ */
+typedef struct Clipboard_broker Clipboard_broker;
+
+/**
+ * Starts broker.
+ *
+ * @param[in] open_timeout_ms Time in milliseconds to wait for clipboard as Clipboard_open_timeout().
+ *
+ * @return Broker.
+ * @retval NULL On failure.
+ */
+Clipboard_broker* Clipboard_broker_start(DWORD open_timeout_ms);
+
+/**
+ * Stops broker.
+ *
+ * Requests that are already submitted are executed before broker stops.
+ *
+ * @param[in] broker Broker. Freed on return.
+ */
+void Clipboard_broker_stop(Clipboard_broker *broker);
+
+/**
+ * Submits request without waiting for it.
+ *
+ * @note Can be called from any thread.
+ *
+ * @param[in] broker Broker.
+ * @param[in] request Request. Must stay valid until Clipboard_broker_wait() returns.
+ */
+void Clipboard_broker_submit(Clipboard_broker *broker, Clipboard_request *request);
+
+/**
+ * Waits for submitted request to complete.
+ *
+ * @param[in] broker Broker.
+ * @param[in] request Request.
+ *
+ * @return Result of request.
+ */
+size_t Clipboard_broker_wait(Clipboard_broker *broker, Clipboard_request *request);
+
+/**
+ * Submits request and waits for it to complete.
+ *
+ * @note Can be called from any thread.
+ *
+ * @param[in] broker Broker.
+ * @param[in] request Request.
+ *
+ * @return Result of request.
+ */
+size_t Clipboard_broker_call(Clipboard_broker *broker, Clipboard_request *request);
+
+/**
+ * @return Broker statistics.
+ */
+Clipboard_broker_stats Clipboard_broker_get_stats(Clipboard_broker *broker);
+
+/*@}*/
@@ -0,0 +1,140 @@
+/**
+ * @file
+ *
+ * Source code of @ref ClipboardCache module.
+ */
+
+#include <stdlib.h>
+
+#include "clipboard_cache.h"
+
+/**
+ * Unlinks entry from list of cache.
+ */
+static void entry_unlink(Clipboard_cache *cache, Clipboard_cache_entry *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->head = entry->next;
+
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->tail = entry->prev;
+
+    entry->prev = NULL;
+    entry->next = NULL;
+}
+
+/**
+ * Links entry as most recently used.
+ */
+static void entry_push_front(Clipboard_cache *cache, Clipboard_cache_entry *entry) {
+    entry->prev = NULL;
+    entry->next = cache->head;
+
+    if (cache->head) cache->head->prev = entry;
+    else cache->tail = entry;
+
+    cache->head = entry;
+}
+
+/**
+ * Unlinks and frees entry.
+ */
+static void entry_drop(Clipboard_cache *cache, Clipboard_cache_entry *entry) {
+    entry_unlink(cache, entry);
+    cache->stats.used -= entry->size;
+    free(entry);
+}
+
+/**
+ * @return Entry of format or NULL.
+ */
+static Clipboard_cache_entry* entry_find(const Clipboard_cache *cache, UINT format) {
+    for (Clipboard_cache_entry *entry = cache->head; entry != NULL; entry = entry->next) {
+        if (entry->format == format) return entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * Reads format from clipboard into new entry.
+ *
+ * @return New entry or NULL on failure or if content doesn't fit capacity.
+ */
+static Clipboard_cache_entry* entry_load(Clipboard_cache *cache, UINT format, size_t *size) {
+    Clipboard_cache_entry *entry = NULL;
+
+    *size = 0;
+    if (!Clipboard_open()) return NULL;
+
+    /* Sequence number cannot move while clipboard is opened by us. */
+    const DWORD seq_num = Clipboard_get_seq_num();
+
+    if (seq_num != cache->seq_num) {
+        Clipboard_cache_clear(cache);
+        cache->seq_num = seq_num;
+    }
+
+    *size = Clipboard_get_size(format);
+
+    if (*size <= cache->capacity) {
+        entry = (Clipboard_cache_entry*)malloc(sizeof(*entry) + *size);
+    }
+
+    if (entry) {
+        entry->format = format;
+        entry->size = *size > 0 ? Clipboard_get(format, entry->data, *size) : 0;
+    }
+
+    (void)Clipboard_close();
+    return entry;
+}
+
+void Clipboard_cache_init(Clipboard_cache *cache, size_t capacity) {
+    cache->head = NULL;
+    cache->tail = NULL;
+    cache->seq_num = 0;
+    cache->capacity = capacity;
+    cache->stats = (Clipboard_cache_stats){0};
+}
+
+void Clipboard_cache_clear(Clipboard_cache *cache) {
+    while (cache->head) entry_drop(cache, cache->head);
+}
+
+const uint8_t* Clipboard_cache_get(Clipboard_cache *cache, UINT format, size_t *size) {
+    const DWORD seq_num = Clipboard_get_seq_num();
+
+    if (seq_num != 0 && seq_num == cache->seq_num) {
+        Clipboard_cache_entry *entry = entry_find(cache, format);
+
+        if (entry) {
+            cache->stats.hits++;
+            entry_unlink(cache, entry);
+            entry_push_front(cache, entry);
+
+            *size = entry->size;
+            return entry->size > 0 ? entry->data : NULL;
+        }
+    }
+
+    cache->stats.misses++;
+
+    Clipboard_cache_entry *entry = entry_load(cache, format, size);
+
+    if (entry == NULL) return NULL;
+
+    while (cache->tail && cache->stats.used + entry->size > cache->capacity) {
+        entry_drop(cache, cache->tail);
+        cache->stats.evictions++;
+    }
+
+    entry_push_front(cache, entry);
+    cache->stats.used += entry->size;
+
+    *size = entry->size;
+    return entry->size > 0 ? entry->data : NULL;
+}
+
+Clipboard_cache_stats Clipboard_cache_get_stats(const Clipboard_cache *cache) {
+    return cache->stats;
+}
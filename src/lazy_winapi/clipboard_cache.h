@@ -0,0 +1,147 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ClipboardCache module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "clipboard.h"
+
+/**
+ * @addtogroup ClipboardCache
+ *
+ * Per-format cache of clipboard content keyed by clipboard sequence number.
+ *
+ * Requires @ref Clipboard module.
+ *
+ * While sequence number stays the same, content is returned from cache
+ * without opening clipboard. Once it moves, every cached format is dropped.
+ * Total size of cached content is limited by capacity and least recently
+ * used formats are evicted to fit new ones.
+ *
+ * @warning Cache isn't thread safe.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Poll clipboard text
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard_cache.h"
+
+    Clipboard_cache cache;
+    size_t size;
+
+    Clipboard_cache_init(&cache, 1024 * 1024);
+
+    for (;;) {
+        const uint8_t *text = Clipboard_cache_get(&cache, CF_TEXT, &size);
+
+        if (text) printf("Content of clipboard=%s\n", (const char*)text);
+        Sleep(100);
+    }
+
+    Clipboard_cache_clear(&cache);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Cached content of one format.
+ */
+typedef struct Clipboard_cache_entry {
+    /** More recently used entry. */
+    struct Clipboard_cache_entry *prev;
+    /** Less recently used entry. */
+    struct Clipboard_cache_entry *next;
+    /** Clipboard format. */
+    UINT format;
+    /** Size of content. 0 if format isn't available. */
+    size_t size;
+    /** Content. */
+    uint8_t data[];
+} Clipboard_cache_entry;
+
+/**
+ * Cache statistics.
+ */
+typedef struct {
+    /** Number of lookups served from cache. */
+    size_t hits;
+    /** Number of lookups that had to read clipboard. */
+    size_t misses;
+    /** Number of entries evicted to fit capacity. */
+    size_t evictions;
+    /** Number of bytes currently cached. */
+    size_t used;
+} Clipboard_cache_stats;
+
+/**
+ * Clipboard cache.
+ *
+ * Fields are private and should be accessed only via functions.
+ */
+typedef struct {
+    /** Most recently used entry. */
+    Clipboard_cache_entry *head;
+    /** Least recently used entry. */
+    Clipboard_cache_entry *tail;
+    /** Sequence number of cached content. */
+    DWORD seq_num;
+    /** Maximum number of bytes to cache. */
+    size_t capacity;
+    /** Statistics. */
+    Clipboard_cache_stats stats;
+} Clipboard_cache;
+
+/**
+ * Initializes empty cache.
+ *
+ * @param[out] cache Cache to initialize.
+ * @param[in] capacity Maximum number of content bytes to keep.
+ */
+void Clipboard_cache_init(Clipboard_cache *cache, size_t capacity);
+
+/**
+ * Drops every cached entry and frees its memory.
+ *
+ * Statistics are preserved.
+ *
+ * @param[in,out] cache Cache to clear.
+ */
+void Clipboard_cache_clear(Clipboard_cache *cache);
+
+/**
+ * Retrieves clipboard content of specific format.
+ *
+ * If clipboard sequence number didn't change since content was cached,
+ * it is returned without opening clipboard.
+ * Otherwise clipboard is opened and closed by cache itself.
+ *
+ * @note Must not be called while clipboard is opened by Clipboard_open().
+ *
+ * @param[in,out] cache Cache to use.
+ * @param[in] format Format of clipboard to retrieve.
+ * @param[out] size Size of content in bytes.
+ *                  If content is bigger than cache capacity, it is not cached and only its size is set.
+ *
+ * @return Pointer to cached content. Valid until next call with the same cache.
+ * @retval NULL Format is not available, too big or clipboard cannot be read.
+ */
+const uint8_t* Clipboard_cache_get(Clipboard_cache *cache, UINT format, size_t *size);
+
+/**
+ * Retrieves cache statistics.
+ *
+ * @param[in] cache Cache to inspect.
+ *
+ * @return Copy of statistics.
+ */
+Clipboard_cache_stats Clipboard_cache_get_stats(const Clipboard_cache *cache);
+
+/*@}*/
@@ -0,0 +1,409 @@
+/**
+ * @file
+ *
+ * Source code of @ref ClipboardMem module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "clipboard_mem.h"
+
+/** Maximum number of formats on clipboard. */
+#define MEM_FORMATS_MAX 64
+/** Maximum number of registered formats. */
+#define MEM_NAMES_MAX 64
+/** Maximum length of registered format's name. Including null char. */
+#define MEM_NAME_LEN 128
+/** First identifier of registered format. */
+#define MEM_NAME_FIRST 0xC000
+
+/**
+ * Global memory block.
+ */
+typedef struct {
+    size_t size;
+    /** Lock count. Guarded by lock of clipboard state. */
+    size_t locks;
+    uint8_t data[];
+} mem_global;
+
+/**
+ * Clipboard content of one format.
+ */
+typedef struct {
+    UINT format;
+    /** NULL if format is to be rendered by owner. */
+    mem_global *data;
+} mem_format;
+
+/**
+ * In-memory clipboard.
+ */
+static struct {
+    SRWLOCK lock;
+    bool opened;
+    /** Thread that opened clipboard. */
+    DWORD opener_thread;
+    /** Window that opened clipboard. */
+    HWND opener;
+    /** Thread of owner while it renders format on request. 0 otherwise. */
+    DWORD render_thread;
+    /** Window that emptied clipboard last time. */
+    HWND owner;
+    DWORD seq_num;
+    mem_format formats[MEM_FORMATS_MAX];
+    size_t formats_len;
+    wchar_t names[MEM_NAMES_MAX][MEM_NAME_LEN];
+    size_t names_len;
+} state = {
+    .lock = SRWLOCK_INIT,
+    .seq_num = 1
+};
+
+/**
+ * @return Format's content or NULL.
+ */
+static mem_format* mem_find(UINT format) {
+    for (size_t idx = 0; idx < state.formats_len; idx++) {
+        if (state.formats[idx].format == format) return &state.formats[idx];
+    }
+
+    return NULL;
+}
+
+/**
+ * @return Whether clipboard is opened by the calling thread.
+ */
+static bool mem_is_opener() {
+    return state.opened && state.opener_thread == GetCurrentThreadId();
+}
+
+/**
+ * Frees content of every format.
+ */
+static void mem_free_formats() {
+    for (size_t idx = 0; idx < state.formats_len; idx++) {
+        free(state.formats[idx].data);
+    }
+
+    state.formats_len = 0;
+}
+
+static bool mem_open(HWND owner) {
+    bool result = false;
+
+    AcquireSRWLockExclusive(&state.lock);
+    /* Thread that holds clipboard can open it again. */
+    if (!state.opened || mem_is_opener()) {
+        state.opened = true;
+        state.opener_thread = GetCurrentThreadId();
+        state.opener = owner;
+        result = true;
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    if (!result) SetLastError(ERROR_ACCESS_DENIED);
+    return result;
+}
+
+static bool mem_close() {
+    bool result = false;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (mem_is_opener()) {
+        state.opened = false;
+        state.opener_thread = 0;
+        state.opener = NULL;
+        result = true;
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    if (!result) SetLastError(ERROR_CLIPBOARD_NOT_OPEN);
+    return result;
+}
+
+static bool mem_empty() {
+    HWND old_owner = NULL;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (!mem_is_opener()) {
+        ReleaseSRWLockExclusive(&state.lock);
+        SetLastError(ERROR_CLIPBOARD_NOT_OPEN);
+        return false;
+    }
+
+    old_owner = state.owner;
+    mem_free_formats();
+    state.owner = state.opener;
+    state.seq_num++;
+    ReleaseSRWLockExclusive(&state.lock);
+
+    if (old_owner != NULL) (void)SendMessageW(old_owner, WM_DESTROYCLIPBOARD, 0, 0);
+    return true;
+}
+
+static HANDLE mem_get_data(UINT format) {
+    HANDLE result = NULL;
+    HWND owner = NULL;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (state.opened) {
+        const mem_format *content = mem_find(format);
+
+        if (content) {
+            result = content->data;
+            if (result == NULL) owner = state.owner;
+        }
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    if (owner == NULL) return result;
+
+    /* Owner sets content on request, without opening clipboard. */
+    AcquireSRWLockExclusive(&state.lock);
+    state.render_thread = GetWindowThreadProcessId(owner, NULL);
+    ReleaseSRWLockExclusive(&state.lock);
+
+    (void)SendMessageW(owner, WM_RENDERFORMAT, format, 0);
+
+    AcquireSRWLockExclusive(&state.lock);
+    state.render_thread = 0;
+    const mem_format *content = mem_find(format);
+    result = content ? content->data : NULL;
+    ReleaseSRWLockExclusive(&state.lock);
+
+    return result;
+}
+
+static HANDLE mem_set_data(UINT format, HANDLE data) {
+    DWORD error = ERROR_SUCCESS;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (!mem_is_opener() && state.render_thread != GetCurrentThreadId()) {
+        error = ERROR_CLIPBOARD_NOT_OPEN;
+    }
+    else if (data == NULL && state.owner == NULL) {
+        /* Nobody to render content. */
+        error = ERROR_INVALID_PARAMETER;
+    }
+    else {
+        mem_format *content = mem_find(format);
+
+        if (content) {
+            if (content->data != data) free(content->data);
+            content->data = (mem_global*)data;
+        }
+        else if (state.formats_len < MEM_FORMATS_MAX) {
+            state.formats[state.formats_len].format = format;
+            state.formats[state.formats_len].data = (mem_global*)data;
+            state.formats_len++;
+        }
+        else {
+            error = ERROR_NOT_ENOUGH_MEMORY;
+        }
+    }
+
+    if (error == ERROR_SUCCESS) state.seq_num++;
+    ReleaseSRWLockExclusive(&state.lock);
+
+    SetLastError(error);
+    return error == ERROR_SUCCESS ? data : NULL;
+}
+
+static HWND mem_get_owner() {
+    AcquireSRWLockShared(&state.lock);
+    const HWND result = state.owner;
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static DWORD mem_get_seq_num() {
+    AcquireSRWLockShared(&state.lock);
+    const DWORD result = state.seq_num;
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static UINT mem_enum_formats(UINT format) {
+    UINT result = 0;
+
+    AcquireSRWLockShared(&state.lock);
+    if (state.opened) {
+        size_t idx = 0;
+
+        if (format != 0) {
+            while (idx < state.formats_len && state.formats[idx].format != format) idx++;
+            idx++;
+        }
+
+        if (idx < state.formats_len) result = state.formats[idx].format;
+    }
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static int mem_count_formats() {
+    AcquireSRWLockShared(&state.lock);
+    const int result = (int)state.formats_len;
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static bool mem_is_format_avail(UINT format) {
+    AcquireSRWLockShared(&state.lock);
+    const bool result = mem_find(format) != NULL;
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static UINT mem_register_format(const wchar_t *name) {
+    UINT result = 0;
+
+    if (wcslen(name) >= MEM_NAME_LEN) return 0;
+
+    AcquireSRWLockExclusive(&state.lock);
+    for (size_t idx = 0; idx < state.names_len; idx++) {
+        if (_wcsicmp(state.names[idx], name) == 0) {
+            result = MEM_NAME_FIRST + (UINT)idx;
+            break;
+        }
+    }
+
+    if (result == 0 && state.names_len < MEM_NAMES_MAX) {
+        (void)wcscpy(state.names[state.names_len], name);
+        result = MEM_NAME_FIRST + (UINT)state.names_len;
+        state.names_len++;
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    return result;
+}
+
+static int mem_get_format_name(UINT format, wchar_t *buffer, int size) {
+    int result = 0;
+
+    if (size <= 0 || format < MEM_NAME_FIRST) return 0;
+
+    AcquireSRWLockShared(&state.lock);
+    if (format - MEM_NAME_FIRST < state.names_len) {
+        const wchar_t *name = state.names[format - MEM_NAME_FIRST];
+
+        while (result < size - 1 && name[result] != 0) {
+            buffer[result] = name[result];
+            result++;
+        }
+        buffer[result] = 0;
+    }
+    ReleaseSRWLockShared(&state.lock);
+
+    return result;
+}
+
+static HGLOBAL mem_global_alloc(UINT flags, size_t size) {
+    (void)flags;
+    mem_global *result = (mem_global*)calloc(1, sizeof(*result) + size);
+
+    if (result) result->size = size;
+    return result;
+}
+
+static void* mem_global_lock(HGLOBAL handle) {
+    mem_global *global = (mem_global*)handle;
+
+    if (global == NULL) return NULL;
+
+    AcquireSRWLockExclusive(&state.lock);
+    global->locks++;
+    ReleaseSRWLockExclusive(&state.lock);
+
+    return global->data;
+}
+
+static bool mem_global_unlock(HGLOBAL handle) {
+    mem_global *global = (mem_global*)handle;
+    bool result = false;
+
+    if (global == NULL) return false;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (global->locks > 0) {
+        global->locks--;
+        result = global->locks > 0;
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    return result;
+}
+
+static size_t mem_global_size(HGLOBAL handle) {
+    const mem_global *global = (const mem_global*)handle;
+
+    return global ? global->size : 0;
+}
+
+static HGLOBAL mem_global_free(HGLOBAL handle) {
+    free(handle);
+    return NULL;
+}
+
+static HGLOBAL mem_global_realloc(HGLOBAL handle, size_t size, UINT flags) {
+    (void)flags;
+    mem_global *global = (mem_global*)handle;
+
+    mem_global *result = NULL;
+
+    if (global == NULL) return NULL;
+
+    AcquireSRWLockExclusive(&state.lock);
+    if (global->locks == 0) {
+        result = (mem_global*)realloc(global, sizeof(*result) + size);
+
+        if (result) {
+            if (size > result->size) memset(result->data + result->size, 0, size - result->size);
+            result->size = size;
+        }
+    }
+    ReleaseSRWLockExclusive(&state.lock);
+
+    return result;
+}
+
+const Clipboard_backend Clipboard_backend_mem = {
+    .open = mem_open,
+    .close = mem_close,
+    .empty = mem_empty,
+    .get_data = mem_get_data,
+    .set_data = mem_set_data,
+    .get_owner = mem_get_owner,
+    .get_seq_num = mem_get_seq_num,
+    .enum_formats = mem_enum_formats,
+    .count_formats = mem_count_formats,
+    .is_format_avail = mem_is_format_avail,
+    .register_format = mem_register_format,
+    .get_format_name = mem_get_format_name,
+    .global_alloc = mem_global_alloc,
+    .global_lock = mem_global_lock,
+    .global_unlock = mem_global_unlock,
+    .global_size = mem_global_size,
+    .global_free = mem_global_free,
+    .global_realloc = mem_global_realloc
+};
+
+void Clipboard_mem_reset() {
+    AcquireSRWLockExclusive(&state.lock);
+    mem_free_formats();
+    state.names_len = 0;
+    state.opened = false;
+    state.opener_thread = 0;
+    state.opener = NULL;
+    state.render_thread = 0;
+    state.owner = NULL;
+    state.seq_num++;
+    ReleaseSRWLockExclusive(&state.lock);
+}
@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ClipboardMem module.
+ */
+
+#include <windows.h>
+
+#include "clipboard.h"
+
+/**
+ * @addtogroup ClipboardMem
+ *
+ * In-memory backend for @ref Clipboard module.
+ *
+ * Clipboard is modeled within the current process so that module can be
+ * tested and benchmarked without desktop session and without interfering with
+ * user's clipboard.
+ *
+ * Model follows WinAPI:
+ * - Clipboard can be opened only by one thread until it is closed, and that thread can open it again;
+ * - Only thread that opened clipboard can close, empty and set it, except that owner can set format on `WM_RENDERFORMAT`;
+ * - Emptying clipboard makes the window that opened it owner,
+ *   and previous owner receives `WM_DESTROYCLIPBOARD`;
+ * - Sequence number is incremented on empty and on each set;
+ * - Formats are enumerated in the order they are set;
+ * - Format set with NULL data is rendered on request by sending `WM_RENDERFORMAT` to owner;
+ * - Registered formats get identifiers starting from `0xC000`.
+ *
+ * Backend is safe to use from multiple threads.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Use in-memory clipboard
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard_mem.h"
+
+    const Clipboard_backend *old_backend = Clipboard_set_backend(&Clipboard_backend_mem);
+
+    Clipboard_open();
+    Clipboard_set_string("For my waifu!");
+    Clipboard_close();
+
+    Clipboard_set_backend(old_backend);
+    Clipboard_mem_reset();
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * In-memory backend.
+ */
+extern const Clipboard_backend Clipboard_backend_mem;
+
+/**
+ * Resets in-memory clipboard to initial state.
+ *
+ * Frees content, forgets registered formats and owner.
+ * Sequence number keeps increasing.
+ *
+ * @note Clipboard must not be opened.
+ */
+void Clipboard_mem_reset();
+
+/*@}*/
@@ -0,0 +1,234 @@
+/**
+ * @file
+ *
+ * Source code of @ref ClipboardWatch module.
+ */
+
+#include <stdlib.h>
+
+#include "clipboard_watch.h"
+
+/** Name of window class for watcher. */
+static const wchar_t WATCH_CLASS[] = L"lazy_winapi_clipboard_watch";
+/** Identifier of coalescing timer. */
+static const UINT_PTR WATCH_TIMER = 1;
+
+struct Clipboard_watch {
+    /** Watcher's thread. */
+    HANDLE thread;
+    /** Signaled once thread is ready to receive updates. */
+    HANDLE ready;
+    /** Listener window. Owned by watcher's thread. */
+    HWND window;
+    /** Whether listener was registered. */
+    bool listening;
+
+    Clipboard_watch_fn callback;
+    void *ctx;
+    DWORD coalesce_ms;
+    /** Number of updates since last notification. Accessed only by watcher's thread. */
+    size_t pending;
+    /** Whether coalescing timer is running. Accessed only by watcher's thread. */
+    bool timer;
+
+    /** Guards fields below. */
+    CRITICAL_SECTION lock;
+    /** Signaled on notification. */
+    CONDITION_VARIABLE changed;
+    Clipboard_watch_stats stats;
+};
+
+/**
+ * Delivers pending updates as single notification.
+ */
+static void watch_notify(Clipboard_watch *watch) {
+    const size_t updates = watch->pending;
+
+    if (updates == 0) return;
+    watch->pending = 0;
+
+    EnterCriticalSection(&watch->lock);
+    watch->stats.updates += updates;
+    watch->stats.notifications++;
+    LeaveCriticalSection(&watch->lock);
+    WakeAllConditionVariable(&watch->changed);
+
+    if (watch->callback) watch->callback(watch->ctx, updates);
+}
+
+/**
+ * Counts update and schedules notification.
+ */
+static void watch_update(Clipboard_watch *watch, HWND window) {
+    MSG msg;
+
+    watch->pending++;
+
+    /* Swallow updates that are already queued. */
+    while (PeekMessageW(&msg, window, WM_CLIPBOARDUPDATE, WM_CLIPBOARDUPDATE, PM_REMOVE)) {
+        watch->pending++;
+    }
+
+    if (watch->coalesce_ms == 0) {
+        watch_notify(watch);
+    }
+    else if (!watch->timer) {
+        watch->timer = SetTimer(window, WATCH_TIMER, watch->coalesce_ms, NULL) != 0;
+
+        if (!watch->timer) watch_notify(watch);
+    }
+}
+
+/**
+ * Window procedure of watcher.
+ */
+static LRESULT CALLBACK watch_proc(HWND window, UINT msg, WPARAM wparam, LPARAM lparam) {
+    Clipboard_watch *watch = (Clipboard_watch*)GetWindowLongPtrW(window, GWLP_USERDATA);
+
+    if (watch == NULL) return DefWindowProcW(window, msg, wparam, lparam);
+
+    switch (msg) {
+        case WM_CLIPBOARDUPDATE:
+            watch_update(watch, window);
+            return 0;
+        case WM_TIMER:
+            (void)KillTimer(window, WATCH_TIMER);
+            watch->timer = false;
+            watch_notify(watch);
+            return 0;
+        case WM_CLOSE:
+            (void)DestroyWindow(window);
+            return 0;
+        case WM_DESTROY:
+            if (watch->listening) (void)RemoveClipboardFormatListener(window);
+            PostQuitMessage(0);
+            return 0;
+        default:
+            return DefWindowProcW(window, msg, wparam, lparam);
+    }
+}
+
+/**
+ * Watcher's thread.
+ */
+static DWORD WINAPI watch_thread(LPVOID param) {
+    Clipboard_watch *watch = (Clipboard_watch*)param;
+    const HINSTANCE instance = GetModuleHandleW(NULL);
+    const WNDCLASSEXW window_class = {
+        .cbSize = sizeof(window_class),
+        .lpfnWndProc = watch_proc,
+        .hInstance = instance,
+        .lpszClassName = WATCH_CLASS
+    };
+    MSG msg;
+
+    /* Fails if class is already registered by another watcher. */
+    (void)RegisterClassExW(&window_class);
+
+    const HWND window = CreateWindowExW(0, WATCH_CLASS, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, instance, NULL);
+
+    if (window != NULL) {
+        (void)SetWindowLongPtrW(window, GWLP_USERDATA, (LONG_PTR)watch);
+        watch->listening = AddClipboardFormatListener(window) != 0;
+
+        if (!watch->listening) {
+            (void)DestroyWindow(window);
+            (void)GetMessageW(&msg, NULL, WM_QUIT, WM_QUIT);
+        }
+        else {
+            watch->window = window;
+        }
+    }
+
+    (void)SetEvent(watch->ready);
+    if (watch->window == NULL) return 1;
+
+    while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+        (void)TranslateMessage(&msg);
+        (void)DispatchMessageW(&msg);
+    }
+
+    return 0;
+}
+
+Clipboard_watch* Clipboard_watch_start(Clipboard_watch_fn callback, void *ctx, DWORD coalesce_ms) {
+    Clipboard_watch *watch = (Clipboard_watch*)calloc(1, sizeof(*watch));
+
+    if (watch == NULL) return NULL;
+
+    watch->callback = callback;
+    watch->ctx = ctx;
+    watch->coalesce_ms = coalesce_ms;
+    InitializeCriticalSection(&watch->lock);
+    InitializeConditionVariable(&watch->changed);
+
+    watch->ready = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (watch->ready != NULL) {
+        watch->thread = CreateThread(NULL, 0, watch_thread, watch, 0, NULL);
+    }
+
+    if (watch->thread != NULL) {
+        (void)WaitForSingleObject(watch->ready, INFINITE);
+
+        if (watch->window != NULL) return watch;
+
+        (void)WaitForSingleObject(watch->thread, INFINITE);
+        (void)CloseHandle(watch->thread);
+    }
+
+    if (watch->ready != NULL) (void)CloseHandle(watch->ready);
+    DeleteCriticalSection(&watch->lock);
+    free(watch);
+    return NULL;
+}
+
+void Clipboard_watch_stop(Clipboard_watch *watch) {
+    (void)PostMessageW(watch->window, WM_CLOSE, 0, 0);
+    (void)WaitForSingleObject(watch->thread, INFINITE);
+
+    (void)CloseHandle(watch->thread);
+    (void)CloseHandle(watch->ready);
+    DeleteCriticalSection(&watch->lock);
+    free(watch);
+}
+
+bool Clipboard_watch_wait(Clipboard_watch *watch, size_t *seen, DWORD timeout_ms) {
+    const DWORD start = GetTickCount();
+    bool result = true;
+
+    EnterCriticalSection(&watch->lock);
+    while (*seen == watch->stats.notifications) {
+        DWORD remaining = INFINITE;
+
+        if (timeout_ms != INFINITE) {
+            const DWORD elapsed = GetTickCount() - start;
+
+            if (elapsed >= timeout_ms) {
+                result = false;
+                break;
+            }
+            remaining = timeout_ms - elapsed;
+        }
+
+        (void)SleepConditionVariableCS(&watch->changed, &watch->lock, remaining);
+    }
+    /* Every notification so far is seen at once. */
+    *seen = watch->stats.notifications;
+    LeaveCriticalSection(&watch->lock);
+
+    return result;
+}
+
+bool Clipboard_watch_fire(Clipboard_watch *watch) {
+    return PostMessageW(watch->window, WM_CLIPBOARDUPDATE, 0, 0) != 0;
+}
+
+Clipboard_watch_stats Clipboard_watch_get_stats(Clipboard_watch *watch) {
+    Clipboard_watch_stats stats;
+
+    EnterCriticalSection(&watch->lock);
+    stats = watch->stats;
+    LeaveCriticalSection(&watch->lock);
+
+    return stats;
+}
@@ -0,0 +1,131 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ClipboardWatch module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+/**
+ * @addtogroup ClipboardWatch
+ *
+ * Notifications about clipboard changes without polling.
+ *
+ * Watcher owns dedicated thread with hidden message-only window
+ * that is registered by `AddClipboardFormatListener`.
+ * Each `WM_CLIPBOARDUPDATE` is counted as update, and bursts of updates
+ * are coalesced into single notification.
+ *
+ * Notification is delivered either by invoking callback on watcher's thread,
+ * or by waking up threads that wait in Clipboard_watch_wait().
+ *
+ * Examples
+ * ---------
+ *
+ * ### Wait for clipboard change
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "clipboard_watch.h"
+
+    Clipboard_watch *watch = Clipboard_watch_start(NULL, NULL, 10);
+    size_t seen = 0;
+
+    while (Clipboard_watch_wait(watch, &seen, INFINITE)) {
+        printf("Clipboard changed\n");
+    }
+
+    Clipboard_watch_stop(watch);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Callback to invoke on clipboard change.
+ *
+ * Invoked on watcher's thread.
+ *
+ * @param[in] ctx User's context from Clipboard_watch_start().
+ * @param[in] updates Number of updates coalesced into this notification.
+ */
+typedef void (*Clipboard_watch_fn)(void *ctx, size_t updates);
+
+/**
+ * Watcher statistics.
+ */
+typedef struct {
+    /** Number of received updates. */
+    size_t updates;
+    /** Number of delivered notifications. */
+    size_t notifications;
+} Clipboard_watch_stats;
+
+/**
+ * Clipboard watcher.
+ */
+typedef struct Clipboard_watch Clipboard_watch;
+
+/**
+ * Starts watching clipboard changes.
+ *
+ * @param[in] callback Callback to invoke on change. Can be NULL.
+ * @param[in] ctx User's context to pass into callback.
+ * @param[in] coalesce_ms Time in milliseconds to wait for more updates before notification.
+ *                        If 0, only updates that are already queued get coalesced.
+ *
+ * @return Watcher.
+ * @retval NULL On failure.
+ */
+Clipboard_watch* Clipboard_watch_start(Clipboard_watch_fn callback, void *ctx, DWORD coalesce_ms);
+
+/**
+ * Stops watcher and frees its resources.
+ *
+ * Threads that wait in Clipboard_watch_wait() must be finished before.
+ *
+ * @param[in] watch Watcher to stop.
+ */
+void Clipboard_watch_stop(Clipboard_watch *watch);
+
+/**
+ * Waits for clipboard change.
+ *
+ * Returns immediately if there was notification that caller hasn't seen yet.
+ * Each waiting thread keeps its own @p seen so every one of them is woken up by notification.
+ *
+ * @param[in] watch Watcher.
+ * @param[in,out] seen Number of notifications seen by caller. Updated on change.
+ *                     Start with 0 to include notifications delivered so far
+ *                     or with Clipboard_watch_stats::notifications to wait only for new ones.
+ * @param[in] timeout_ms Time to wait in milliseconds. `INFINITE` to wait without timeout.
+ *
+ * @retval true Clipboard changed.
+ * @retval false On timeout.
+ */
+bool Clipboard_watch_wait(Clipboard_watch *watch, size_t *seen, DWORD timeout_ms);
+
+/**
+ * Sends synthetic update to watcher.
+ *
+ * Update goes through the same path as the one sent by system.
+ *
+ * @param[in] watch Watcher.
+ *
+ * @retval true On success.
+ * @retval false On failure.
+ */
+bool Clipboard_watch_fire(Clipboard_watch *watch);
+
+/**
+ * Retrieves watcher statistics.
+ *
+ * @param[in] watch Watcher.
+ *
+ * @return Copy of statistics.
+ */
+Clipboard_watch_stats Clipboard_watch_get_stats(Clipboard_watch *watch);
+
+/*@}*/
@@ -0,0 +1,302 @@
+/**
+ * @file
+ *
+ * Source code of @ref Dib module.
+ */
+
+#include "dib.h"
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define DIB_AVX2
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#   include <tmmintrin.h>
+#   define DIB_SSSE3
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define DIB_SSE2
+#endif
+
+/** Size of `BITMAPINFOHEADER`. */
+#define DIB_HEADER_SIZE 40
+/** Size of header with red, green and blue masks. */
+#define DIB_HEADER_RGB_MASKS_SIZE 52
+/** Size of header with alpha mask. */
+#define DIB_HEADER_ALPHA_MASK_SIZE 56
+
+/** Uncompressed pixels. */
+#define DIB_RGB 0
+/** Pixels with red, green and blue masks. */
+#define DIB_BITFIELDS 3
+/** Pixels with red, green, blue and alpha masks. */
+#define DIB_ALPHABITFIELDS 6
+
+/** Masks of 16 bits uncompressed pixels. */
+static const uint32_t MASKS_555[4] = {0x7C00, 0x03E0, 0x001F, 0};
+/** Masks of 24 and 32 bits uncompressed pixels. */
+static const uint32_t MASKS_888[4] = {0xFF0000, 0x00FF00, 0x0000FF, 0};
+/** Alpha mask of 32 bits pixels in BGRA order. */
+#define MASK_ALPHA_8888 0xFF000000u
+
+static uint16_t read_u16(const uint8_t *src) {
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+/**
+ * @return Whether mask is contiguous run of bits within pixel.
+ */
+static bool mask_is_valid(uint32_t mask, uint16_t bit_count) {
+    const uint32_t low_bit = mask & (~mask + 1);
+
+    if (mask == 0 || ((mask + low_bit) & mask) != 0) return false;
+
+    return bit_count >= 32 || mask < ((uint32_t)1 << bit_count);
+}
+
+bool Dib_parse(const uint8_t *data, size_t size, Dib_info *info) {
+    if (size < DIB_HEADER_SIZE) return false;
+
+    const uint32_t header_size = read_u32(data);
+    const int32_t width = (int32_t)read_u32(data + 4);
+    const int32_t height = (int32_t)read_u32(data + 8);
+    const uint16_t bit_count = read_u16(data + 14);
+    const uint32_t compression = read_u32(data + 16);
+    const uint32_t colors = read_u32(data + 32);
+    uint64_t offset = header_size;
+
+    if (header_size < DIB_HEADER_SIZE || header_size > size) return false;
+    if (width <= 0 || height == 0 || height == INT32_MIN) return false;
+    if (bit_count != 16 && bit_count != 24 && bit_count != 32) return false;
+
+    switch (compression) {
+        case DIB_RGB:
+            for (size_t idx = 0; idx < 4; idx++) info->masks[idx] = bit_count == 16 ? MASKS_555[idx] : MASKS_888[idx];
+            break;
+        case DIB_BITFIELDS:
+        case DIB_ALPHABITFIELDS: {
+            const bool has_alpha = compression == DIB_ALPHABITFIELDS || header_size >= DIB_HEADER_ALPHA_MASK_SIZE;
+            const uint8_t *masks = data + DIB_HEADER_SIZE;
+
+            if (bit_count == 24) return false;
+
+            if (header_size < DIB_HEADER_RGB_MASKS_SIZE) {
+                /* Masks follow BITMAPINFOHEADER. */
+                const size_t masks_size = compression == DIB_ALPHABITFIELDS ? 16 : 12;
+
+                if (size - header_size < masks_size) return false;
+                masks = data + header_size;
+                offset += masks_size;
+            }
+
+            for (size_t idx = 0; idx < 3; idx++) info->masks[idx] = read_u32(masks + idx * 4);
+            info->masks[3] = 0;
+
+            if (!has_alpha) break;
+
+            if (header_size >= DIB_HEADER_RGB_MASKS_SIZE && header_size < DIB_HEADER_ALPHA_MASK_SIZE) {
+                /* Header has only red, green and blue masks so alpha mask follows it. */
+                if (size - header_size < 4) return false;
+                info->masks[3] = read_u32(data + header_size);
+                offset += 4;
+            }
+            else {
+                info->masks[3] = read_u32(masks + 12);
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+
+    for (size_t idx = 0; idx < 4; idx++) {
+        if (idx == 3 && info->masks[idx] == 0) break;
+        if (!mask_is_valid(info->masks[idx], bit_count)) return false;
+    }
+
+    /* Color table is optional for these bit counts and is skipped. */
+    if (colors > (size - offset) / 4) return false;
+    offset += (uint64_t)colors * 4;
+
+    const uint32_t rows = height < 0 ? (uint32_t)-height : (uint32_t)height;
+    const uint64_t stride = ((uint64_t)(uint32_t)width * bit_count + 31) / 32 * 4;
+
+    if (stride * rows > size - offset) return false;
+    /* RGBA result must be addressable. */
+    if ((uint64_t)(uint32_t)width * rows > SIZE_MAX / 4) return false;
+
+    info->width = (uint32_t)width;
+    info->height = rows;
+    info->bit_count = bit_count;
+    info->top_down = height < 0;
+    info->stride = (size_t)stride;
+    info->pixels_offset = (size_t)offset;
+    return true;
+}
+
+/**
+ * Converts row of BGRA pixels into RGBA.
+ *
+ * @param[in] alpha Bits to set in every pixel. MASK_ALPHA_8888 to make pixels opaque, 0 to keep alpha.
+ */
+static void row_bgra_to_rgba(const uint8_t *src, uint8_t *dst, size_t width, uint32_t alpha) {
+    size_t idx = 0;
+
+#if defined(DIB_AVX2)
+    const __m256i shuffle256 = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i alpha256 = _mm256_set1_epi32((int)alpha);
+
+    for (; idx + 8 <= width; idx += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i*)(src + idx * 4));
+
+        _mm256_storeu_si256((__m256i*)(dst + idx * 4), _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle256), alpha256));
+    }
+#endif
+
+#if defined(DIB_SSE2)
+    const __m128i red_blue = _mm_set1_epi32(0x00FF00FF);
+    const __m128i alpha128 = _mm_set1_epi32((int)alpha);
+
+    for (; idx + 4 <= width; idx += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i*)(src + idx * 4));
+        const __m128i rb = _mm_and_si128(pixels, red_blue);
+        /* Swap red and blue within each pixel, keeping green and alpha. */
+        const __m128i br = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+        const __m128i result = _mm_or_si128(_mm_or_si128(br, _mm_andnot_si128(red_blue, pixels)), alpha128);
+
+        _mm_storeu_si128((__m128i*)(dst + idx * 4), result);
+    }
+#endif
+
+    for (; idx < width; idx++) {
+        dst[idx * 4] = src[idx * 4 + 2];
+        dst[idx * 4 + 1] = src[idx * 4 + 1];
+        dst[idx * 4 + 2] = src[idx * 4];
+        dst[idx * 4 + 3] = (uint8_t)(src[idx * 4 + 3] | (alpha >> 24));
+    }
+}
+
+/**
+ * Converts row of BGR pixels into opaque RGBA.
+ */
+static void row_bgr_to_rgba(const uint8_t *src, uint8_t *dst, size_t width) {
+    size_t idx = 0;
+
+#if defined(DIB_AVX2)
+    const __m256i shuffle256 = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                                2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m256i alpha256 = _mm256_set1_epi32((int)MASK_ALPHA_8888);
+
+    /* Second load reads 4 bytes past 8 pixels. */
+    for (; idx + 10 <= width; idx += 8) {
+        const __m128i low = _mm_loadu_si128((const __m128i*)(src + idx * 3));
+        const __m128i high = _mm_loadu_si128((const __m128i*)(src + idx * 3 + 12));
+        const __m256i pixels = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+        _mm256_storeu_si256((__m256i*)(dst + idx * 4), _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle256), alpha256));
+    }
+#endif
+
+#if defined(DIB_SSSE3)
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+    const __m128i alpha128 = _mm_set1_epi32((int)MASK_ALPHA_8888);
+
+    /* Load reads 4 bytes past 4 pixels. */
+    for (; idx + 6 <= width; idx += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i*)(src + idx * 3));
+
+        _mm_storeu_si128((__m128i*)(dst + idx * 4), _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha128));
+    }
+#endif
+
+    for (; idx < width; idx++) {
+        dst[idx * 4] = src[idx * 3 + 2];
+        dst[idx * 4 + 1] = src[idx * 3 + 1];
+        dst[idx * 4 + 2] = src[idx * 3];
+        dst[idx * 4 + 3] = 0xFF;
+    }
+}
+
+/**
+ * Channel of pixel described by mask.
+ */
+typedef struct {
+    uint32_t mask;
+    unsigned shift;
+    unsigned bits;
+} dib_channel;
+
+static dib_channel channel_from_mask(uint32_t mask) {
+    dib_channel result = {mask, 0, 0};
+
+    if (mask == 0) return result;
+
+    while (((mask >> result.shift) & 1) == 0) result.shift++;
+    while (result.shift + result.bits < 32 && ((mask >> (result.shift + result.bits)) & 1) != 0) result.bits++;
+
+    return result;
+}
+
+/**
+ * @return Value of channel scaled to 8 bits.
+ */
+static uint8_t channel_get(const dib_channel *channel, uint32_t pixel) {
+    const uint32_t value = (pixel & channel->mask) >> channel->shift;
+
+    if (channel->bits >= 8) return (uint8_t)(value >> (channel->bits - 8));
+
+    const uint32_t max = ((uint32_t)1 << channel->bits) - 1;
+    return (uint8_t)((value * 255 + max / 2) / max);
+}
+
+/**
+ * Converts row of pixels with arbitrary masks into RGBA.
+ */
+static void row_masks_to_rgba(const uint8_t *src, uint8_t *dst, size_t width, uint16_t bit_count, const dib_channel *channels) {
+    const size_t pixel_size = bit_count / 8;
+
+    for (size_t idx = 0; idx < width; idx++) {
+        const uint8_t *pixel_ptr = src + idx * pixel_size;
+        const uint32_t pixel = pixel_size == 2 ? read_u16(pixel_ptr) : read_u32(pixel_ptr);
+
+        dst[idx * 4] = channel_get(&channels[0], pixel);
+        dst[idx * 4 + 1] = channel_get(&channels[1], pixel);
+        dst[idx * 4 + 2] = channel_get(&channels[2], pixel);
+        dst[idx * 4 + 3] = channels[3].mask ? channel_get(&channels[3], pixel) : 0xFF;
+    }
+}
+
+void Dib_to_rgba(const Dib_info *info, const uint8_t *data, uint8_t *rgba) {
+    const uint8_t *pixels = data + info->pixels_offset;
+    const size_t rgba_stride = (size_t)info->width * 4;
+    const bool is_bgra = info->bit_count == 32 &&
+                         info->masks[0] == MASKS_888[0] && info->masks[1] == MASKS_888[1] && info->masks[2] == MASKS_888[2] &&
+                         (info->masks[3] == 0 || info->masks[3] == MASK_ALPHA_8888);
+    dib_channel channels[4];
+
+    for (size_t idx = 0; idx < 4; idx++) channels[idx] = channel_from_mask(info->masks[idx]);
+
+    for (size_t row = 0; row < info->height; row++) {
+        const size_t src_row = info->top_down ? row : info->height - 1 - row;
+        const uint8_t *src = pixels + src_row * info->stride;
+        uint8_t *dst = rgba + row * rgba_stride;
+
+        if (info->bit_count == 24) {
+            row_bgr_to_rgba(src, dst, info->width);
+        }
+        else if (is_bgra) {
+            row_bgra_to_rgba(src, dst, info->width, info->masks[3] ? 0 : MASK_ALPHA_8888);
+        }
+        else {
+            row_masks_to_rgba(src, dst, info->width, info->bit_count, channels);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref Dib module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup Dib
+ *
+ * Portable parser of device independent bitmaps, as used by formats `CF_DIB` and `CF_DIBV5`,
+ * and their conversion into RGBA.
+ *
+ * Module does not depend on WinAPI.
+ *
+ * Supported layouts:
+ * - `BITMAPINFOHEADER`, `BITMAPV4HEADER` and `BITMAPV5HEADER`, including masks that follow header;
+ * - 16, 24 and 32 bits per pixel;
+ * - `BI_RGB`, `BI_BITFIELDS` and `BI_ALPHABITFIELDS` compressions;
+ * - Bottom-up and top-down orientation.
+ *
+ * Common 24 and 32 bits layouts are converted with SSE2, SSSE3 or AVX2 when compiler targets them,
+ * the rest falls back to scalar code.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Convert bitmap into RGBA
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "dib.h"
+
+    Dib_info info;
+
+    if (Dib_parse(data, size, &info)) {
+        uint8_t *rgba = malloc((size_t)info.width * info.height * 4);
+        Dib_to_rgba(&info, data, rgba);
+    }
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Parsed bitmap.
+ */
+typedef struct {
+    /** Width in pixels. */
+    uint32_t width;
+    /** Height in pixels. */
+    uint32_t height;
+    /** Bits per pixel. */
+    uint16_t bit_count;
+    /** Whether the first row of pixels is the top one. */
+    bool top_down;
+    /** Masks of red, green, blue and alpha channels. Alpha mask is 0 if there is no alpha. */
+    uint32_t masks[4];
+    /** Size of row in bytes, including padding. */
+    size_t stride;
+    /** Offset of pixels from start of bitmap. */
+    size_t pixels_offset;
+} Dib_info;
+
+/**
+ * Parses bitmap.
+ *
+ * @param[in] data Bitmap, starting with header.
+ * @param[in] size Size of bitmap.
+ * @param[out] info Parsed bitmap.
+ *
+ * @retval true On success.
+ * @retval false If bitmap is malformed, has unsupported layout or its pixels don't fit into size.
+ */
+bool Dib_parse(const uint8_t *data, size_t size, Dib_info *info);
+
+/**
+ * Converts pixels of bitmap into top-down RGBA.
+ *
+ * Pixels without alpha channel are converted as opaque.
+ *
+ * @param[in] info Bitmap parsed by Dib_parse().
+ * @param[in] data Bitmap, same as parsed.
+ * @param[out] rgba Memory to hold `width * height * 4` bytes.
+ */
+void Dib_to_rgba(const Dib_info *info, const uint8_t *data, uint8_t *rgba);
+
+/*@}*/
@@ -0,0 +1,78 @@
+/**
+ * @file
+ *
+ * Source code of @ref Drop module.
+ */
+
+#include <string.h>
+
+#include "drop.h"
+
+/** Offset of `DROPFILES::pFiles`. */
+#define DROP_FILES_OFFSET 0
+/** Offset of `DROPFILES::fWide`. */
+#define DROP_WIDE_OFFSET 16
+
+/**
+ * @return Little endian 32-bit value.
+ */
+static uint32_t read_u32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+bool Drop_iter_init(Drop_iter *iter, const uint8_t *data, size_t size) {
+    if (size < DROP_HEADER_SIZE) return false;
+
+    const uint32_t files = read_u32(data + DROP_FILES_OFFSET);
+    const bool wide = read_u32(data + DROP_WIDE_OFFSET) != 0;
+
+    if (files < DROP_HEADER_SIZE || files > size) return false;
+    /* Wide paths are yielded in place, so they must be aligned. */
+    if (wide && files % sizeof(uint16_t) != 0) return false;
+
+    iter->data = data;
+    iter->size = size;
+    iter->offset = files;
+    iter->wide = wide;
+    return true;
+}
+
+bool Drop_iter_next(Drop_iter *iter, Drop_path *path) {
+    if (iter->offset >= iter->size) return false;
+
+    const uint8_t *start = iter->data + iter->offset;
+    const size_t remaining = iter->size - iter->offset;
+    size_t len = 0;
+
+    if (iter->wide) {
+        const uint16_t *wide = (const uint16_t*)(const void*)start;
+        const size_t wide_size = remaining / sizeof(uint16_t);
+
+        while (len < wide_size && wide[len] != 0) len++;
+
+        if (len == 0 || len == wide_size) {
+            iter->offset = iter->size;
+            return false;
+        }
+
+        path->ansi = NULL;
+        path->wide = wide;
+        iter->offset += (len + 1) * sizeof(uint16_t);
+    }
+    else {
+        const uint8_t *end = (const uint8_t*)memchr(start, 0, remaining);
+
+        if (end == NULL || end == start) {
+            iter->offset = iter->size;
+            return false;
+        }
+
+        len = (size_t)(end - start);
+        path->ansi = (const char*)start;
+        path->wide = NULL;
+        iter->offset += len + 1;
+    }
+
+    path->len = len;
+    return true;
+}
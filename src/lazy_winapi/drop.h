@@ -0,0 +1,95 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref Drop module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup Drop
+ *
+ * Portable parser of file lists in `DROPFILES` layout, as used by format `CF_HDROP`.
+ *
+ * Module does not depend on WinAPI.
+ * Paths are yielded as pointers into parsed memory, without copying or allocation.
+ * Both ANSI and wide layouts are supported.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Print every path of wide list
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "drop.h"
+
+    Drop_iter iter;
+    Drop_path path;
+
+    if (Drop_iter_init(&iter, data, size)) {
+        while (Drop_iter_next(&iter, &path)) {
+            if (path.wide) wprintf(L"%.*ls\n", (int)path.len, (const wchar_t*)path.wide);
+        }
+    }
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/** Size of `DROPFILES` header. */
+#define DROP_HEADER_SIZE 20
+
+/**
+ * Iterator over paths.
+ */
+typedef struct {
+    /** Parsed memory. */
+    const uint8_t *data;
+    /** Size of parsed memory. */
+    size_t size;
+    /** Offset of next path. */
+    size_t offset;
+    /** Whether paths are wide. */
+    bool wide;
+} Drop_iter;
+
+/**
+ * Path within parsed memory.
+ */
+typedef struct {
+    /** ANSI path. NULL if paths are wide. */
+    const char *ansi;
+    /** Wide path. NULL if paths are ANSI. */
+    const uint16_t *wide;
+    /** Length of path in chars. Excluding null char. */
+    size_t len;
+} Drop_path;
+
+/**
+ * Initializes iterator.
+ *
+ * @param[out] iter Iterator.
+ * @param[in] data Memory in `DROPFILES` layout. Aligned at least as uint16_t.
+ * @param[in] size Size of memory.
+ *
+ * @retval true On success.
+ * @retval false If header is malformed.
+ */
+bool Drop_iter_init(Drop_iter *iter, const uint8_t *data, size_t size);
+
+/**
+ * Retrieves next path.
+ *
+ * Iteration ends at empty path or at path that is not null terminated within memory.
+ *
+ * @param[in, out] iter Iterator.
+ * @param[out] path Path.
+ *
+ * @retval true On success.
+ * @retval false If there are no more paths.
+ */
+bool Drop_iter_next(Drop_iter *iter, Drop_path *path);
+
+/*@}*/
@@ -0,0 +1,213 @@
+/**
+ * @file
+ *
+ * Source code of @ref Lz module.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "lz.h"
+
+/** Minimum length of match. */
+#define LZ_MIN_MATCH 4
+/** Maximum offset of match. */
+#define LZ_MAX_OFFSET 0xFFFF
+/** Number of bits in hash of match candidates. */
+#define LZ_HASH_BITS 12
+/** Nibble value that is continued by following bytes. */
+#define LZ_NIBBLE_MAX 15
+/** Size of blocks that are copied past end of short copy when there is room for it. */
+#define LZ_WILD_COPY 16
+
+static inline uint32_t read_u32(const uint8_t *src) {
+    uint32_t result;
+    (void)memcpy(&result, src, sizeof(result));
+    return result;
+}
+
+static inline uint64_t read_u64(const uint8_t *src) {
+    uint64_t result;
+    (void)memcpy(&result, src, sizeof(result));
+    return result;
+}
+
+static inline size_t hash_u32(uint32_t value) {
+    return (size_t)((value * 2654435761u) >> (32 - LZ_HASH_BITS));
+}
+
+/**
+ * Writes continuation of length.
+ *
+ * @return Position after written bytes or NULL if they don't fit.
+ */
+static uint8_t* write_len(uint8_t *dst, const uint8_t *dst_end, size_t len) {
+    for (; len >= 255; len -= 255) {
+        if (dst >= dst_end) return NULL;
+        *dst++ = 255;
+    }
+
+    if (dst >= dst_end) return NULL;
+    *dst++ = (uint8_t)len;
+    return dst;
+}
+
+/**
+ * Writes sequence.
+ *
+ * @param[in] match_len Length of match. 0 for the last sequence.
+ *
+ * @return Position after sequence or NULL if it doesn't fit.
+ */
+static uint8_t* write_seq(uint8_t *dst, const uint8_t *dst_end, const uint8_t *literals, size_t literals_len, size_t offset, size_t match_len) {
+    const size_t match_nibble = match_len ? match_len - LZ_MIN_MATCH : 0;
+
+    if (dst >= dst_end) return NULL;
+
+    *dst++ = (uint8_t)(((literals_len < LZ_NIBBLE_MAX ? literals_len : LZ_NIBBLE_MAX) << 4) |
+                       (match_nibble < LZ_NIBBLE_MAX ? match_nibble : LZ_NIBBLE_MAX));
+
+    if (literals_len >= LZ_NIBBLE_MAX) {
+        dst = write_len(dst, dst_end, literals_len - LZ_NIBBLE_MAX);
+        if (dst == NULL) return NULL;
+    }
+
+    if ((size_t)(dst_end - dst) < literals_len) return NULL;
+    (void)memcpy(dst, literals, literals_len);
+    dst += literals_len;
+
+    if (match_len == 0) return dst;
+
+    if (dst_end - dst < 2) return NULL;
+    dst[0] = (uint8_t)offset;
+    dst[1] = (uint8_t)(offset >> 8);
+    dst += 2;
+
+    if (match_nibble >= LZ_NIBBLE_MAX) dst = write_len(dst, dst_end, match_nibble - LZ_NIBBLE_MAX);
+    return dst;
+}
+
+/**
+ * Reads continuation of length.
+ *
+ * @retval false If input ends before length.
+ */
+static bool read_len(const uint8_t **src, const uint8_t *src_end, size_t *len) {
+    uint8_t byte;
+
+    do {
+        if (*src >= src_end || *len > SIZE_MAX - 255) return false;
+        byte = *(*src)++;
+        *len += byte;
+    } while (byte == 255);
+
+    return true;
+}
+
+size_t Lz_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t Lz_decompress_bound(size_t size) {
+    /* Each byte of input produces at most 255 bytes of output, as continuation of match length does. */
+    return size > SIZE_MAX / 255 ? SIZE_MAX : size * 255;
+}
+
+size_t Lz_compress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len) {
+    size_t table[1 << LZ_HASH_BITS] = {0};
+    const uint8_t *dst_end = dst + dst_len;
+    uint8_t *out = dst;
+    size_t anchor = 0;
+    size_t idx = 0;
+    size_t misses = 0;
+
+    while (src_len >= LZ_MIN_MATCH && idx <= src_len - LZ_MIN_MATCH) {
+        const uint32_t value = read_u32(src + idx);
+        const size_t hash = hash_u32(value);
+        const size_t candidate = table[hash];
+
+        table[hash] = idx;
+
+        if (candidate >= idx || idx - candidate > LZ_MAX_OFFSET || read_u32(src + candidate) != value) {
+            /* Skip faster through data that doesn't compress. */
+            idx += 1 + (misses++ >> 5);
+            continue;
+        }
+
+        size_t len = LZ_MIN_MATCH;
+
+        while (idx + len + sizeof(uint64_t) <= src_len && read_u64(src + candidate + len) == read_u64(src + idx + len)) {
+            len += sizeof(uint64_t);
+        }
+        while (idx + len < src_len && src[candidate + len] == src[idx + len]) len++;
+
+        out = write_seq(out, dst_end, src + anchor, idx - anchor, idx - candidate, len);
+        if (out == NULL) return 0;
+
+        idx += len;
+        anchor = idx;
+        misses = 0;
+    }
+
+    out = write_seq(out, dst_end, src + anchor, src_len - anchor, 0, 0);
+    return out ? (size_t)(out - dst) : 0;
+}
+
+size_t Lz_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len) {
+    const uint8_t *src_end = src + src_len;
+    size_t out = 0;
+
+    while (src < src_end) {
+        const uint8_t token = *src++;
+        size_t literals_len = token >> 4;
+
+        if (literals_len == LZ_NIBBLE_MAX && !read_len(&src, src_end, &literals_len)) return 0;
+        if ((size_t)(src_end - src) < literals_len) return 0;
+
+        if (dst_len - out <= literals_len) {
+            (void)memcpy(dst + out, src, dst_len - out);
+            return dst_len;
+        }
+
+        if (literals_len <= LZ_WILD_COPY && dst_len - out >= LZ_WILD_COPY && (size_t)(src_end - src) >= LZ_WILD_COPY) {
+            /* Bytes past literals are overwritten by following output. */
+            (void)memcpy(dst + out, src, LZ_WILD_COPY);
+        }
+        else {
+            (void)memcpy(dst + out, src, literals_len);
+        }
+        src += literals_len;
+        out += literals_len;
+
+        if (src == src_end) break;
+        if (src_end - src < 2) return 0;
+
+        const size_t offset = (size_t)src[0] | ((size_t)src[1] << 8);
+        size_t match_len = token & LZ_NIBBLE_MAX;
+
+        src += 2;
+        if (match_len == LZ_NIBBLE_MAX && !read_len(&src, src_end, &match_len)) return 0;
+        if (offset == 0 || offset > out) return 0;
+
+        match_len += LZ_MIN_MATCH;
+        if (match_len > dst_len - out) match_len = dst_len - out;
+
+        if (offset >= sizeof(uint64_t) && dst_len - out >= match_len + sizeof(uint64_t)) {
+            /* Each block reads only output that is already written. */
+            for (size_t idx = 0; idx < match_len; idx += sizeof(uint64_t)) {
+                (void)memcpy(dst + out + idx, dst + out + idx - offset, sizeof(uint64_t));
+            }
+        }
+        else if (offset >= match_len) {
+            (void)memcpy(dst + out, dst + out - offset, match_len);
+        }
+        else {
+            /* Overlapping match repeats its own output. */
+            for (size_t idx = 0; idx < match_len; idx++) dst[out + idx] = dst[out + idx - offset];
+        }
+
+        out += match_len;
+    }
+
+    return out;
+}
@@ -0,0 +1,82 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref Lz module.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup Lz
+ *
+ * Portable LZ77 codec tuned for speed over ratio.
+ *
+ * Module does not depend on WinAPI.
+ *
+ * Compressed block is a sequence of:
+ * - Token byte. High nibble is number of literals, low nibble is match length minus 4.
+ *   Nibble value 15 means that length continues in following bytes, each added to it
+ *   until byte is not 255;
+ * - Literals;
+ * - Little endian 16-bit offset of match. Omitted in the last sequence, which has only literals;
+ * - Continuation of match length.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Compress and decompress
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "lz.h"
+
+    uint8_t *packed = malloc(Lz_compress_bound(size));
+    const size_t packed_size = Lz_compress(data, size, packed, Lz_compress_bound(size));
+
+    uint8_t *unpacked = malloc(size);
+    Lz_decompress(packed, packed_size, unpacked, size);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * @return Maximum size of compressed data of specified size.
+ */
+size_t Lz_compress_bound(size_t size);
+
+/**
+ * @return Maximum size of data that compressed data of specified size can decompress into.
+ */
+size_t Lz_decompress_bound(size_t size);
+
+/**
+ * Compresses data.
+ *
+ * @param[in] src Data.
+ * @param[in] src_len Size of data.
+ * @param[out] dst Memory to hold compressed data.
+ * @param[in] dst_len Size of dst. Compression always succeeds if it is at least Lz_compress_bound().
+ *
+ * @return Size of compressed data.
+ * @retval 0 If compressed data doesn't fit into dst.
+ */
+size_t Lz_compress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len);
+
+/**
+ * Decompresses data.
+ *
+ * Decompression stops once dst is full, so prefix of data can be extracted.
+ * Bytes of dst past decompressed data might be overwritten.
+ *
+ * @param[in] src Compressed data.
+ * @param[in] src_len Size of compressed data.
+ * @param[out] dst Memory to hold data.
+ * @param[in] dst_len Size of dst.
+ *
+ * @return Size of decompressed data.
+ * @retval 0 If compressed data is malformed.
+ */
+size_t Lz_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len);
+
+/*@}*/
@@ -0,0 +1,252 @@
+/**
+ * @file
+ *
+ * Source code of @ref Pattern module.
+ */
+
+#include <string.h>
+
+#include "pattern.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define PATTERN_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define PATTERN_SSE2
+#endif
+
+#if defined(PATTERN_SSE2)
+/**
+ * @return Index of the lowest set bit in non-zero mask.
+ */
+static inline unsigned first_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long result;
+    (void)_BitScanForward(&result, mask);
+    return (unsigned)result;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+/**
+ * Rough estimate of how common byte is in code and data of processes.
+ *
+ * @return Higher value for more common byte.
+ */
+static unsigned byte_commonness(uint8_t byte) {
+    switch (byte) {
+        case 0x00:
+            return 6;
+        case 0xFF:
+        case 0xCC:
+            return 5;
+        case 0x48:
+        case 0x8B:
+        case 0x89:
+        case 0x90:
+            return 4;
+        case 0x01:
+        case 0x0F:
+        case 0x20:
+        case 0x24:
+        case 0x4C:
+        case 0x83:
+        case 0x8D:
+        case 0xC3:
+        case 0xE8:
+            return 3;
+        default:
+            /* Small integers and lower case text. */
+            return byte < 0x10 || (byte >= 0x61 && byte <= 0x7A) ? 2 : 1;
+    }
+}
+
+/**
+ * Picks fixed bytes to compare first.
+ */
+static void pattern_pick_anchors(Pattern *pattern) {
+    size_t first = pattern->len;
+
+    for (size_t idx = 0; idx < pattern->len; idx++) {
+        if (!pattern->mask[idx]) continue;
+
+        if (first == pattern->len || byte_commonness(pattern->bytes[idx]) < byte_commonness(pattern->bytes[first])) first = idx;
+    }
+
+    pattern->has_fixed = first < pattern->len;
+    pattern->anchors[0] = pattern->has_fixed ? first : 0;
+    pattern->anchors[1] = pattern->anchors[0];
+
+    if (!pattern->has_fixed) return;
+
+    size_t second = pattern->len;
+    size_t second_distance = 0;
+
+    for (size_t idx = 0; idx < pattern->len; idx++) {
+        if (!pattern->mask[idx] || idx == first) continue;
+
+        const size_t distance = idx > first ? idx - first : first - idx;
+
+        /* The farther from the first one, the less likely both are parts of the same false match. */
+        if (second == pattern->len ||
+            byte_commonness(pattern->bytes[idx]) < byte_commonness(pattern->bytes[second]) ||
+            (byte_commonness(pattern->bytes[idx]) == byte_commonness(pattern->bytes[second]) && distance > second_distance)) {
+            second = idx;
+            second_distance = distance;
+        }
+    }
+
+    if (second < pattern->len) pattern->anchors[1] = second;
+}
+
+/**
+ * @return Value of hex digit or -1.
+ */
+static int hex_digit(char digit) {
+    if (digit >= '0' && digit <= '9') return digit - '0';
+    if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+    if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+    return -1;
+}
+
+static bool is_space(char chr) {
+    return chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n';
+}
+
+bool Pattern_compile(Pattern *pattern, const char *text) {
+    memset(pattern, 0, sizeof(*pattern));
+
+    for (;;) {
+        while (is_space(*text)) text++;
+        if (*text == 0) break;
+
+        if (pattern->len == PATTERN_MAX_LEN) return false;
+
+        if (text[0] == '?') {
+            text += text[1] == '?' ? 2 : 1;
+        }
+        else {
+            const int high = hex_digit(text[0]);
+            const int low = high < 0 ? -1 : hex_digit(text[1]);
+
+            if (low < 0) return false;
+
+            pattern->bytes[pattern->len] = (uint8_t)(high << 4 | low);
+            pattern->mask[pattern->len] = 0xFF;
+            text += 2;
+        }
+
+        if (*text != 0 && !is_space(*text)) return false;
+        pattern->len++;
+    }
+
+    if (pattern->len == 0) return false;
+
+    pattern_pick_anchors(pattern);
+    return true;
+}
+
+bool Pattern_from_bytes(Pattern *pattern, const uint8_t *bytes, const uint8_t *mask, size_t len) {
+    memset(pattern, 0, sizeof(*pattern));
+
+    if (len == 0 || len > PATTERN_MAX_LEN) return false;
+
+    pattern->len = len;
+    for (size_t idx = 0; idx < len; idx++) {
+        pattern->mask[idx] = mask == NULL || mask[idx] ? 0xFF : 0;
+        pattern->bytes[idx] = bytes[idx] & pattern->mask[idx];
+    }
+
+    pattern_pick_anchors(pattern);
+    return true;
+}
+
+/**
+ * @return Whether whole pattern matches at data.
+ */
+static inline bool pattern_is_match(const Pattern *pattern, const uint8_t *data) {
+    size_t idx = 0;
+
+    for (; idx + 8 <= pattern->len; idx += 8) {
+        uint64_t value, bytes, mask;
+
+        memcpy(&value, data + idx, sizeof(value));
+        memcpy(&bytes, pattern->bytes + idx, sizeof(bytes));
+        memcpy(&mask, pattern->mask + idx, sizeof(mask));
+
+        if ((value ^ bytes) & mask) return false;
+    }
+
+    for (; idx < pattern->len; idx++) {
+        if ((data[idx] ^ pattern->bytes[idx]) & pattern->mask[idx]) return false;
+    }
+
+    return true;
+}
+
+const uint8_t* Pattern_find(const Pattern *pattern, const uint8_t *data, size_t size) {
+    if (size < pattern->len) return NULL;
+    if (!pattern->has_fixed) return data;
+
+    /* Number of positions where pattern can start. */
+    const size_t positions = size - pattern->len + 1;
+    const uint8_t *first = data + pattern->anchors[0];
+    const uint8_t *second = data + pattern->anchors[1];
+    const uint8_t first_byte = pattern->bytes[pattern->anchors[0]];
+    const uint8_t second_byte = pattern->bytes[pattern->anchors[1]];
+    size_t pos = 0;
+
+#if defined(PATTERN_AVX2)
+    const __m256i first_avx = _mm256_set1_epi8((char)first_byte);
+    const __m256i second_avx = _mm256_set1_epi8((char)second_byte);
+
+    for (; pos + 32 <= positions; pos += 32) {
+        const __m256i first_eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(first + pos)), first_avx);
+        const __m256i second_eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(second + pos)), second_avx);
+
+        for (uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(first_eq, second_eq)); mask != 0; mask &= mask - 1) {
+            const size_t candidate = pos + first_bit(mask);
+
+            if (pattern_is_match(pattern, data + candidate)) return data + candidate;
+        }
+    }
+#endif
+
+#if defined(PATTERN_SSE2)
+    const __m128i first_sse = _mm_set1_epi8((char)first_byte);
+    const __m128i second_sse = _mm_set1_epi8((char)second_byte);
+
+    for (; pos + 16 <= positions; pos += 16) {
+        const __m128i first_eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(first + pos)), first_sse);
+        const __m128i second_eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(second + pos)), second_sse);
+
+        for (uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(first_eq, second_eq)); mask != 0; mask &= mask - 1) {
+            const size_t candidate = pos + first_bit(mask);
+
+            if (pattern_is_match(pattern, data + candidate)) return data + candidate;
+        }
+    }
+#endif
+
+    while (pos < positions) {
+        /* Without SIMD memchr is the fastest way to skip to candidate. */
+        const uint8_t *found = (const uint8_t*)memchr(first + pos, first_byte, positions - pos);
+
+        if (found == NULL) return NULL;
+
+        pos = (size_t)(found - first);
+        if (second[pos] == second_byte && pattern_is_match(pattern, data + pos)) return data + pos;
+        pos++;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,105 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref Pattern module.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup Pattern
+ *
+ * Portable search of byte patterns with wildcards, also known as signatures.
+ *
+ * Module does not depend on WinAPI.
+ *
+ * Pattern is compiled once, picking two of its fixed bytes that are the least
+ * likely to appear in code or data. Search compares both of them at 32 or 16
+ * positions at once with AVX2 or SSE2 when compiler targets them, and only
+ * candidates that match both are compared with the whole pattern.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Find signature in memory
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "pattern.h"
+
+    Pattern pattern;
+
+    if (Pattern_compile(&pattern, "48 8B 05 ?? ?? ?? ?? E8")) {
+        for (const uint8_t *found = Pattern_find(&pattern, data, size);
+             found != NULL;
+             found = Pattern_find(&pattern, found + 1, size - (size_t)(found + 1 - data))) {
+            printf("Match at offset=%zu\n", (size_t)(found - data));
+        }
+    }
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Maximum length of pattern in bytes.
+ */
+#define PATTERN_MAX_LEN 256
+
+/**
+ * Compiled pattern.
+ */
+typedef struct {
+    /** Bytes of pattern. Wildcards are 0. */
+    uint8_t bytes[PATTERN_MAX_LEN];
+    /** 0xFF for fixed bytes and 0 for wildcards. */
+    uint8_t mask[PATTERN_MAX_LEN];
+    /** Length in bytes. */
+    size_t len;
+    /** Offsets of fixed bytes that are compared first. Equal if there is single fixed byte. */
+    size_t anchors[2];
+    /** Whether pattern has at least single fixed byte. */
+    bool has_fixed;
+} Pattern;
+
+/**
+ * Compiles pattern from text.
+ *
+ * Text consists of bytes in hex separated by whitespace, such as `"E8 ?? ?? ?? ?? 48 8B"`.
+ * Wildcard is `?` or `??`.
+ *
+ * @param[out] pattern Pattern.
+ * @param[in] text Text of pattern.
+ *
+ * @retval true On success.
+ * @retval false If text is malformed, empty or longer than PATTERN_MAX_LEN.
+ */
+bool Pattern_compile(Pattern *pattern, const char *text);
+
+/**
+ * Compiles pattern from bytes and mask.
+ *
+ * @param[out] pattern Pattern.
+ * @param[in] bytes Bytes of pattern.
+ * @param[in] mask Non-zero for fixed bytes and zero for wildcards. If NULL, every byte is fixed.
+ * @param[in] len Length of pattern.
+ *
+ * @retval true On success.
+ * @retval false If len is 0 or bigger than PATTERN_MAX_LEN.
+ */
+bool Pattern_from_bytes(Pattern *pattern, const uint8_t *bytes, const uint8_t *mask, size_t len);
+
+/**
+ * Finds the first match of pattern.
+ *
+ * @param[in] pattern Compiled pattern.
+ * @param[in] data Memory to search.
+ * @param[in] size Size of memory.
+ *
+ * @return Start of match.
+ * @retval NULL If there is no match.
+ */
+const uint8_t* Pattern_find(const Pattern *pattern, const uint8_t *data, size_t size);
+
+/*@}*/
@@ -1,3 +1,8 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <psapi.h>
+
 #include "process.h"
 
 /**
@@ -22,6 +27,193 @@ const uint8_t* Process_read_mem(HANDLE process, uintptr_t base, uint8_t* buffer,
     return ReadProcessMemory(process, (void*)base, buffer, size, NULL) != 0 ? buffer : NULL;
 }
 
+/**
+ * Region of Process_read_mem_batch() in order of addresses.
+ */
+typedef struct {
+    uintptr_t base;
+    uintptr_t end;
+    /** Index of region in user's array. */
+    size_t idx;
+} batch_entry;
+
+static int batch_entry_cmp(const void *left, const void *right) {
+    const uintptr_t left_base = ((const batch_entry*)left)->base;
+    const uintptr_t right_base = ((const batch_entry*)right)->base;
+
+    return (left_base > right_base) - (left_base < right_base);
+}
+
+size_t Process_read_mem_batch(HANDLE process, const Process_iovec *remote, size_t len, bool *result) {
+    batch_entry *entries = (batch_entry*)malloc(len * sizeof(*entries));
+    uint8_t *scratch = NULL;
+    size_t entries_len = 0;
+    size_t count = 0;
+    bool sorted = true;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        const Process_iovec *iov = &remote[idx];
+        bool is_read;
+
+        if (iov->size == 0) {
+            is_read = true;
+        }
+        else if (entries == NULL) {
+            /* Without memory to order regions, read them one by one. */
+            is_read = Process_read_mem(process, iov->base, iov->buffer, iov->size) != NULL;
+        }
+        else {
+            if (entries_len > 0 && entries[entries_len - 1].base > iov->base) sorted = false;
+            entries[entries_len++] = (batch_entry){iov->base, iov->base + iov->size, idx};
+            continue;
+        }
+
+        if (result) result[idx] = is_read;
+        count += is_read;
+    }
+
+    if (entries == NULL) return count;
+    if (!sorted) qsort(entries, entries_len, sizeof(*entries), batch_entry_cmp);
+
+    for (size_t start = 0, end; start < entries_len; start = end) {
+        const uintptr_t run_base = entries[start].base;
+        uintptr_t run_end = entries[start].end;
+        bool is_merged = false;
+
+        for (end = start + 1; end < entries_len; end++) {
+            const batch_entry *next = &entries[end];
+            const uintptr_t next_end = next->end > run_end ? next->end : run_end;
+
+            if (next->base > run_end && next->base - run_end > PROCESS_BATCH_MAX_GAP) break;
+            if (next_end - run_base > PROCESS_BATCH_MAX_READ) break;
+
+            run_end = next_end;
+        }
+
+        if (end - start > 1) {
+            if (scratch == NULL) scratch = (uint8_t*)malloc(PROCESS_BATCH_MAX_READ);
+
+            is_merged = scratch != NULL && Process_read_mem(process, run_base, scratch, run_end - run_base) != NULL;
+        }
+
+        for (size_t idx = start; idx < end; idx++) {
+            const Process_iovec *iov = &remote[entries[idx].idx];
+            bool is_read = true;
+
+            if (is_merged) {
+                memcpy(iov->buffer, scratch + (iov->base - run_base), iov->size);
+            }
+            else {
+                /* Single region or merged read failed on some of regions. */
+                is_read = Process_read_mem(process, iov->base, iov->buffer, iov->size) != NULL;
+            }
+
+            if (result) result[entries[idx].idx] = is_read;
+            count += is_read;
+        }
+    }
+
+    free(scratch);
+    free(entries);
+    return count;
+}
+
+#define PROCESS_REGION_TYPES (PROCESS_REGION_IMAGE | PROCESS_REGION_MAPPED | PROCESS_REGION_PRIVATE)
+
+/**
+ * @return Whether region passes filters of flags.
+ */
+static bool region_is_match(unsigned flags, const MEMORY_BASIC_INFORMATION *info) {
+    const DWORD readable = PAGE_READONLY | PAGE_READWRITE | PAGE_WRITECOPY |
+                           PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY;
+
+    if (flags & (PROCESS_REGION_COMMITTED | PROCESS_REGION_READABLE) && info->State != MEM_COMMIT) return false;
+    if (flags & PROCESS_REGION_READABLE && ((info->Protect & readable) == 0 || (info->Protect & PAGE_GUARD))) return false;
+
+    if (flags & PROCESS_REGION_TYPES) {
+        switch (info->Type) {
+            case MEM_IMAGE: return (flags & PROCESS_REGION_IMAGE) != 0;
+            case MEM_MAPPED: return (flags & PROCESS_REGION_MAPPED) != 0;
+            case MEM_PRIVATE: return (flags & PROCESS_REGION_PRIVATE) != 0;
+            /* Free memory has no type. */
+            default: return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Queries regions until the one that passes filters.
+ */
+static bool region_query(Process_region_iter *iter, MEMORY_BASIC_INFORMATION *info) {
+    while (!iter->is_end) {
+        if (VirtualQueryEx(iter->process, (LPCVOID)iter->address, info, sizeof(*info)) == 0) {
+            iter->is_end = true;
+            return false;
+        }
+
+        const uintptr_t next = (uintptr_t)info->BaseAddress + info->RegionSize;
+
+        if (next <= iter->address) iter->is_end = true;
+        iter->address = next;
+
+        if (region_is_match(iter->flags, info)) return true;
+    }
+
+    return false;
+}
+
+void Process_region_iter_init(Process_region_iter *iter, HANDLE process, unsigned flags) {
+    iter->process = process;
+    iter->flags = flags;
+    iter->address = 0;
+    iter->is_end = false;
+    iter->has_pending = false;
+}
+
+bool Process_region_iter_next(Process_region_iter *iter, Process_region *region) {
+    MEMORY_BASIC_INFORMATION info;
+
+    if (iter->has_pending) {
+        info = iter->pending;
+        iter->has_pending = false;
+    }
+    else if (!region_query(iter, &info)) {
+        return false;
+    }
+
+    region->base = (uintptr_t)info.BaseAddress;
+    region->size = info.RegionSize;
+    region->allocation_base = (uintptr_t)info.AllocationBase;
+    region->protect = info.Protect;
+    region->state = info.State;
+    region->type = info.Type;
+    region->file[0] = 0;
+
+    if (iter->flags & PROCESS_REGION_FILE && (info.Type == MEM_IMAGE || info.Type == MEM_MAPPED)) {
+        if (GetMappedFileNameW(iter->process, info.BaseAddress, region->file, MAX_PATH) == 0) region->file[0] = 0;
+    }
+
+    if (iter->flags & PROCESS_REGION_COALESCE) {
+        while (region_query(iter, &iter->pending)) {
+            const MEMORY_BASIC_INFORMATION *next = &iter->pending;
+
+            /* Regions of different files are never merged as they belong to different allocations. */
+            if ((uintptr_t)next->BaseAddress != region->base + region->size ||
+                next->State != region->state || next->Protect != region->protect || next->Type != region->type ||
+                (next->Type != MEM_PRIVATE && (uintptr_t)next->AllocationBase != region->allocation_base)) {
+                iter->has_pending = true;
+                break;
+            }
+
+            region->size += next->RegionSize;
+        }
+    }
+
+    return true;
+}
+
 bool Process_write_mem(HANDLE process, uintptr_t base, const uint8_t* buffer, size_t size) {
     return WriteProcessMemory(process, (void*)base, buffer, size, NULL) != 0;
 }
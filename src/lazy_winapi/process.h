@@ -83,6 +83,129 @@ uint32_t Process_get_window_tid(const HWND window);
  */
 const uint8_t* Process_read_mem(HANDLE process, uintptr_t base, uint8_t* buffer, size_t size);
 
+/**
+ * Region of process memory to read.
+ */
+typedef struct {
+    /** Address in the process. */
+    uintptr_t base;
+    /** Memory to hold read result. */
+    uint8_t *buffer;
+    /** Number of bytes to read. */
+    size_t size;
+} Process_iovec;
+
+/**
+ * Largest gap between regions that Process_read_mem_batch() reads over to merge them.
+ */
+#define PROCESS_BATCH_MAX_GAP 256
+
+/**
+ * Largest size of merged read of Process_read_mem_batch().
+ */
+#define PROCESS_BATCH_MAX_READ (64 * 1024)
+
+/**
+ * Reads multiple regions of process memory.
+ *
+ * Regions are sorted by address, and adjacent, overlapping or close ones are merged
+ * into single read, which is then scattered into buffers of regions.
+ * If merged read fails, its regions are read one by one so that failure of one region
+ * doesn't affect the rest.
+ *
+ * @param[in] process Handle to the process.
+ * @param[in] remote Regions to read. Buffers must not overlap.
+ * @param[in] len Number of regions.
+ * @param[out] result Optional array of len elements to hold whether each region is read.
+ *
+ * @return Number of read regions.
+ */
+size_t Process_read_mem_batch(HANDLE process, const Process_iovec *remote, size_t len, bool *result);
+
+/**
+ * @name Flags of Process_region_iter_init()
+ *
+ * Type flags can be combined, and if none of them is set regions of any type are yielded.
+ * @{
+ */
+/** Yield only committed regions. */
+#define PROCESS_REGION_COMMITTED 0x01
+/** Yield only committed regions that can be read. */
+#define PROCESS_REGION_READABLE 0x02
+/** Yield regions of mapped executable images. */
+#define PROCESS_REGION_IMAGE 0x04
+/** Yield regions of mapped files. */
+#define PROCESS_REGION_MAPPED 0x08
+/** Yield private regions. */
+#define PROCESS_REGION_PRIVATE 0x10
+/** Merge adjacent regions with the same state, protection, type and allocation. */
+#define PROCESS_REGION_COALESCE 0x20
+/** Retrieve name of mapped file. */
+#define PROCESS_REGION_FILE 0x40
+/** @} */
+
+/**
+ * Region of process memory.
+ */
+typedef struct {
+    /** Address of region. */
+    uintptr_t base;
+    /** Size of region. */
+    size_t size;
+    /** Address of allocation that region belongs to. */
+    uintptr_t allocation_base;
+    /** Protection of pages: `PAGE_READONLY`, `PAGE_READWRITE` and etc. 0 unless committed. */
+    DWORD protect;
+    /** State of pages: `MEM_COMMIT`, `MEM_RESERVE` or `MEM_FREE`. */
+    DWORD state;
+    /** Type of pages: `MEM_IMAGE`, `MEM_MAPPED` or `MEM_PRIVATE`. */
+    DWORD type;
+    /**
+     * Device path of mapped file if PROCESS_REGION_FILE is set.
+     * Empty for private regions or if it cannot be retrieved.
+     */
+    wchar_t file[MAX_PATH];
+} Process_region;
+
+/**
+ * Iterator over regions of process memory.
+ *
+ * Fields are private and should be accessed only via functions.
+ */
+typedef struct {
+    HANDLE process;
+    unsigned flags;
+    /** Address to query next. */
+    uintptr_t address;
+    /** Whether address space is over. */
+    bool is_end;
+    /** Whether pending holds region that was queried ahead while coalescing. */
+    bool has_pending;
+    MEMORY_BASIC_INFORMATION pending;
+} Process_region_iter;
+
+/**
+ * Initializes iterator over regions of process memory.
+ *
+ * @note Requires access right PROCESS_QUERY_INFORMATION or PROCESS_QUERY_LIMITED_INFORMATION.
+ *
+ * @param[out] iter Iterator.
+ * @param[in] process Handle to the process.
+ * @param[in] flags Combination of `PROCESS_REGION_*` flags.
+ */
+void Process_region_iter_init(Process_region_iter *iter, HANDLE process, unsigned flags);
+
+/**
+ * Retrieves next region in order of addresses.
+ *
+ * @param[in,out] iter Iterator.
+ * @param[out] region Region.
+ *
+ * @retval true On success.
+ * @retval false If there are no more regions or process cannot be queried.
+ */
+bool Process_region_iter_next(Process_region_iter *iter, Process_region *region);
+
 /**
  * Write into memory of a process.
  *
@@ -0,0 +1,315 @@
+/**
+ * @file
+ *
+ * Source code of @ref ProcessCache module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "process_cache.h"
+
+#define PAGE_MASK ((uintptr_t)PROCESS_CACHE_PAGE_SIZE - 1)
+
+/**
+ * @return Position of key in table if there is no collision.
+ */
+static size_t table_home(const Process_cache *cache, HANDLE process, uintptr_t base) {
+    uint64_t key = (uint64_t)(base / PROCESS_CACHE_PAGE_SIZE) ^ ((uint64_t)(uintptr_t)process << 40);
+
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(key >> 32) & (cache->table_len - 1);
+}
+
+/**
+ * @return Position of page in table or position of empty element where it belongs.
+ */
+static size_t table_find(const Process_cache *cache, HANDLE process, uintptr_t base) {
+    const size_t mask = cache->table_len - 1;
+    size_t pos = table_home(cache, process, base);
+
+    for (; cache->table[pos] != 0; pos = (pos + 1) & mask) {
+        const Process_cache_page *page = &cache->pages[cache->table[pos] - 1];
+
+        if (page->base == base && page->process == process) break;
+    }
+
+    return pos;
+}
+
+/**
+ * Removes element of table, shifting back following elements of the same cluster.
+ */
+static void table_remove(Process_cache *cache, size_t hole) {
+    const size_t mask = cache->table_len - 1;
+
+    for (size_t pos = (hole + 1) & mask; cache->table[pos] != 0; pos = (pos + 1) & mask) {
+        const Process_cache_page *page = &cache->pages[cache->table[pos] - 1];
+        const size_t home = table_home(cache, page->process, page->base);
+
+        /* Element can fill the hole only if the hole lies between its home and its position. */
+        if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+            cache->table[hole] = cache->table[pos];
+            hole = pos;
+        }
+    }
+
+    cache->table[hole] = 0;
+}
+
+/**
+ * Removes page from table and returns it into free list.
+ */
+static void page_drop(Process_cache *cache, uint32_t idx) {
+    Process_cache_page *page = &cache->pages[idx];
+
+    table_remove(cache, table_find(cache, page->process, page->base));
+    page->process = NULL;
+    cache->free[cache->free_len++] = idx;
+}
+
+/**
+ * Takes free page, evicting the one that was not used recently if there is none.
+ *
+ * Pages used by current operation are never evicted.
+ */
+static uint32_t page_alloc(Process_cache *cache) {
+    if (cache->free_len > 0) return cache->free[--cache->free_len];
+
+    for (;;) {
+        const uint32_t idx = (uint32_t)cache->clock;
+        Process_cache_page *page = &cache->pages[idx];
+
+        cache->clock = (cache->clock + 1) % cache->capacity;
+
+        if (page->tick == cache->tick) continue;
+
+        if (page->referenced) {
+            page->referenced = false;
+            continue;
+        }
+
+        page_drop(cache, idx);
+        cache->stats.evictions++;
+        return cache->free[--cache->free_len];
+    }
+}
+
+/**
+ * Starts new operation.
+ */
+static void cache_next_tick(Process_cache *cache) {
+    if (++cache->tick == 0) {
+        /* Pages must not appear as used by operation after wrap around. */
+        for (size_t idx = 0; idx < cache->capacity; idx++) cache->pages[idx].tick = 0;
+        cache->tick = 1;
+    }
+}
+
+/**
+ * Looks up len consecutive pages starting at base, reading missing ones at once.
+ *
+ * Indexes of pages are stored into found and whether they were cached into hit.
+ *
+ * @param[in] len Number of pages, no more than capacity.
+ *
+ * @return Whether every page is read.
+ */
+static bool cache_load(Process_cache *cache, HANDLE process, uintptr_t base, size_t len) {
+    size_t missing = 0;
+    bool is_read = true;
+
+    cache_next_tick(cache);
+
+    for (size_t idx = 0; idx < len; idx++) {
+        const uintptr_t page_base = base + idx * PROCESS_CACHE_PAGE_SIZE;
+        const size_t pos = table_find(cache, process, page_base);
+        uint32_t page_idx = cache->table[pos];
+
+        if (page_idx != 0) {
+            page_idx--;
+
+            if (cache->pages[page_idx].generation == cache->generation) {
+                cache->pages[page_idx].tick = cache->tick;
+                cache->pages[page_idx].referenced = true;
+                cache->found[idx] = page_idx;
+                cache->hit[idx] = true;
+                cache->stats.hits++;
+                continue;
+            }
+
+            /* Stale page is read again in place. */
+        }
+        else {
+            page_idx = page_alloc(cache);
+            /* Eviction can move elements of table. */
+            cache->table[table_find(cache, process, page_base)] = page_idx + 1;
+        }
+
+        Process_cache_page *page = &cache->pages[page_idx];
+
+        page->process = process;
+        page->base = page_base;
+        page->generation = cache->generation;
+        page->tick = cache->tick;
+        page->referenced = false;
+
+        cache->found[idx] = page_idx;
+        cache->hit[idx] = false;
+        cache->iovecs[missing] = (Process_iovec){page_base, cache->data + (size_t)page_idx * PROCESS_CACHE_PAGE_SIZE, PROCESS_CACHE_PAGE_SIZE};
+        missing++;
+    }
+
+    if (missing == 0) return true;
+
+    cache->stats.reads++;
+    cache->stats.misses += missing;
+
+    if (Process_read_mem_batch(process, cache->iovecs, missing, cache->results) == missing) return true;
+
+    /* Pages that cannot be read must not stay cached. */
+    for (size_t idx = 0, iovec_idx = 0; idx < len; idx++) {
+        if (cache->hit[idx]) continue;
+
+        if (!cache->results[iovec_idx++]) {
+            page_drop(cache, cache->found[idx]);
+            is_read = false;
+        }
+    }
+
+    return is_read;
+}
+
+bool Process_cache_init(Process_cache *cache, size_t budget) {
+    const size_t capacity = budget / PROCESS_CACHE_PAGE_SIZE;
+
+    memset(cache, 0, sizeof(*cache));
+    if (capacity == 0 || capacity > UINT32_MAX / 2) return false;
+
+    cache->capacity = capacity;
+    for (cache->table_len = 1; cache->table_len < capacity * 2; cache->table_len *= 2);
+
+    cache->pages = (Process_cache_page*)calloc(capacity, sizeof(*cache->pages));
+    cache->data = (uint8_t*)malloc(capacity * PROCESS_CACHE_PAGE_SIZE);
+    cache->table = (uint32_t*)calloc(cache->table_len, sizeof(*cache->table));
+    cache->free = (uint32_t*)malloc(capacity * sizeof(*cache->free));
+    cache->found = (uint32_t*)malloc(capacity * sizeof(*cache->found));
+    cache->hit = (bool*)malloc(capacity * sizeof(*cache->hit));
+    cache->iovecs = (Process_iovec*)malloc(capacity * sizeof(*cache->iovecs));
+    cache->results = (bool*)malloc(capacity * sizeof(*cache->results));
+
+    if (!cache->pages || !cache->data || !cache->table || !cache->free || !cache->found || !cache->hit || !cache->iovecs || !cache->results) {
+        Process_cache_free(cache);
+        return false;
+    }
+
+    cache->tick = 1;
+    Process_cache_invalidate(cache);
+    return true;
+}
+
+void Process_cache_free(Process_cache *cache) {
+    free(cache->pages);
+    free(cache->data);
+    free(cache->table);
+    free(cache->free);
+    free(cache->found);
+    free(cache->hit);
+    free(cache->iovecs);
+    free(cache->results);
+    memset(cache, 0, sizeof(*cache));
+}
+
+const uint8_t* Process_cache_read(Process_cache *cache, HANDLE process, uintptr_t base, uint8_t *buffer, size_t size) {
+    if (size == 0) return buffer;
+
+    const uintptr_t last = (base + size - 1) & ~PAGE_MASK;
+    uintptr_t page_base = base & ~PAGE_MASK;
+    size_t offset = 0;
+
+    for (;;) {
+        size_t len = (size_t)((last - page_base) / PROCESS_CACHE_PAGE_SIZE) + 1;
+
+        if (len > cache->capacity) len = cache->capacity;
+        if (!cache_load(cache, process, page_base, len)) return NULL;
+
+        /* Copy before next pages can evict these. */
+        for (size_t idx = 0; idx < len; idx++, page_base += PROCESS_CACHE_PAGE_SIZE) {
+            const size_t page_offset = offset == 0 ? (size_t)(base & PAGE_MASK) : 0;
+            size_t copy = PROCESS_CACHE_PAGE_SIZE - page_offset;
+
+            if (copy > size - offset) copy = size - offset;
+
+            memcpy(buffer + offset, cache->data + (size_t)cache->found[idx] * PROCESS_CACHE_PAGE_SIZE + page_offset, copy);
+            if (cache->hit[idx]) cache->stats.bytes_saved += copy;
+            offset += copy;
+        }
+
+        if (offset == size) return buffer;
+    }
+}
+
+bool Process_cache_prefetch(Process_cache *cache, HANDLE process, uintptr_t base, size_t size) {
+    bool is_read = true;
+
+    if (size == 0) return true;
+
+    const uintptr_t last = (base + size - 1) & ~PAGE_MASK;
+
+    for (uintptr_t page_base = base & ~PAGE_MASK;;) {
+        size_t len = (size_t)((last - page_base) / PROCESS_CACHE_PAGE_SIZE) + 1;
+
+        if (len > cache->capacity) len = cache->capacity;
+        /* Keep going so that the rest of range is cached. */
+        is_read &= cache_load(cache, process, page_base, len);
+
+        if (page_base + (len - 1) * PROCESS_CACHE_PAGE_SIZE == last) return is_read;
+        page_base += len * PROCESS_CACHE_PAGE_SIZE;
+    }
+}
+
+void Process_cache_invalidate(Process_cache *cache) {
+    memset(cache->table, 0, cache->table_len * sizeof(*cache->table));
+
+    for (size_t idx = 0; idx < cache->capacity; idx++) {
+        cache->pages[idx].process = NULL;
+        /* Free list is popped from the end, so pages are taken in order. */
+        cache->free[idx] = (uint32_t)(cache->capacity - idx - 1);
+    }
+
+    cache->free_len = cache->capacity;
+    cache->clock = 0;
+}
+
+void Process_cache_invalidate_range(Process_cache *cache, HANDLE process, uintptr_t base, size_t size) {
+    if (size == 0) return;
+
+    const uintptr_t first = base & ~PAGE_MASK;
+    const uintptr_t last = (base + size - 1) & ~PAGE_MASK;
+
+    if ((last - first) / PROCESS_CACHE_PAGE_SIZE >= cache->capacity) {
+        /* Range is bigger than cache, so it is cheaper to check every page. */
+        for (uint32_t idx = 0; idx < cache->capacity; idx++) {
+            const Process_cache_page *page = &cache->pages[idx];
+
+            if (page->process == process && page->base >= first && page->base <= last) page_drop(cache, idx);
+        }
+
+        return;
+    }
+
+    for (uintptr_t page_base = first;; page_base += PROCESS_CACHE_PAGE_SIZE) {
+        const uint32_t page_idx = cache->table[table_find(cache, process, page_base)];
+
+        if (page_idx != 0) page_drop(cache, page_idx - 1);
+        if (page_base == last) return;
+    }
+}
+
+uint32_t Process_cache_next_generation(Process_cache *cache) {
+    return ++cache->generation;
+}
+
+Process_cache_stats Process_cache_get_stats(const Process_cache *cache) {
+    return cache->stats;
+}
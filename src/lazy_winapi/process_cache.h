@@ -0,0 +1,219 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ProcessCache module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "process.h"
+
+/**
+ * @addtogroup ProcessCache
+ *
+ * Page granular cache of process memory.
+ *
+ * Requires @ref Process module.
+ *
+ * Memory is cached in pages of PROCESS_CACHE_PAGE_SIZE keyed by process handle and page address.
+ * Number of pages is limited by budget and pages that were not used recently are evicted to fit new ones.
+ * Pages that are missing for single read or prefetch are read at once with Process_read_mem_batch().
+ *
+ * Cache never observes changes of process memory by itself, and content is considered valid until invalidated:
+ * - Process_cache_invalidate() drops every page;
+ * - Process_cache_invalidate_range() drops pages of range;
+ * - Process_cache_next_generation() makes every page stale at once, for example on each frame.
+ *
+ * @warning Cache isn't thread safe.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Read fields of structure each frame
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "process_cache.h"
+
+    Process_cache cache;
+    uint32_t health;
+    uint32_t ammo;
+
+    Process_cache_init(&cache, 1024 * 1024);
+
+    for (;;) {
+        Process_cache_next_generation(&cache);
+        Process_cache_prefetch(&cache, process, player, 512);
+
+        Process_cache_read(&cache, process, player + 0x10, (uint8_t*)&health, sizeof(health));
+        Process_cache_read(&cache, process, player + 0x14, (uint8_t*)&ammo, sizeof(ammo));
+    }
+
+    Process_cache_free(&cache);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Size of cached page.
+ */
+#define PROCESS_CACHE_PAGE_SIZE 4096
+
+/**
+ * Cached page.
+ */
+typedef struct {
+    /** Process of page. NULL if page is free. */
+    HANDLE process;
+    /** Address of page. */
+    uintptr_t base;
+    /** Generation that page was read in. */
+    uint32_t generation;
+    /** Operation that last used page. Page is not evicted during it. */
+    uint32_t tick;
+    /** Whether page was used since eviction scan has passed it. */
+    bool referenced;
+} Process_cache_page;
+
+/**
+ * Cache statistics.
+ */
+typedef struct {
+    /** Number of pages served from cache. */
+    size_t hits;
+    /** Number of pages read from process. */
+    size_t misses;
+    /** Number of bytes copied from cache instead of process. */
+    size_t bytes_saved;
+    /** Number of pages evicted to fit budget. */
+    size_t evictions;
+    /** Number of reads from process. */
+    size_t reads;
+} Process_cache_stats;
+
+/**
+ * Process memory cache.
+ *
+ * Fields are private and should be accessed only via functions.
+ */
+typedef struct {
+    /** Pages. */
+    Process_cache_page *pages;
+    /** Memory of pages. */
+    uint8_t *data;
+    /** Maximum number of pages. */
+    size_t capacity;
+
+    /** Indexes of pages plus one in open addressing table. 0 is empty. */
+    uint32_t *table;
+    /** Power of two size of table. */
+    size_t table_len;
+
+    /** Indexes of free pages. */
+    uint32_t *free;
+    size_t free_len;
+    /** Position of eviction scan. */
+    size_t clock;
+
+    /** Scratch memory of single operation, capacity elements each. */
+    uint32_t *found;
+    bool *hit;
+    Process_iovec *iovecs;
+    bool *results;
+
+    /** Current generation. */
+    uint32_t generation;
+    /** Current operation. */
+    uint32_t tick;
+    /** Statistics. */
+    Process_cache_stats stats;
+} Process_cache;
+
+/**
+ * Initializes empty cache.
+ *
+ * @param[out] cache Cache to initialize.
+ * @param[in] budget Maximum number of bytes of cached pages. Must fit at least single page.
+ *
+ * @retval true On success.
+ * @retval false If budget is too small or memory cannot be allocated.
+ */
+bool Process_cache_init(Process_cache *cache, size_t budget);
+
+/**
+ * Frees memory of cache.
+ *
+ * @param[in,out] cache Cache to free.
+ */
+void Process_cache_free(Process_cache *cache);
+
+/**
+ * Reads memory of process through cache.
+ *
+ * Pages of range that are not cached are read at once.
+ *
+ * @param[in,out] cache Cache to use.
+ * @param[in] process Handle to the process.
+ * @param[in] base Address in the process from which to read.
+ * @param[out] buffer Memory to hold read result.
+ * @param[in] size Number of bytes to read.
+ *
+ * @return buffer on success.
+ * @retval NULL If some of pages cannot be read.
+ */
+const uint8_t* Process_cache_read(Process_cache *cache, HANDLE process, uintptr_t base, uint8_t *buffer, size_t size);
+
+/**
+ * Reads every page of range into cache ahead of Process_cache_read().
+ *
+ * @param[in,out] cache Cache to use.
+ * @param[in] process Handle to the process.
+ * @param[in] base Address of range.
+ * @param[in] size Size of range. Only the last budget worth of pages stays cached for bigger ranges.
+ *
+ * @retval true If every page of range is cached.
+ * @retval false If some of pages cannot be read.
+ */
+bool Process_cache_prefetch(Process_cache *cache, HANDLE process, uintptr_t base, size_t size);
+
+/**
+ * Drops every cached page.
+ *
+ * @param[in,out] cache Cache to invalidate.
+ */
+void Process_cache_invalidate(Process_cache *cache);
+
+/**
+ * Drops cached pages that overlap range.
+ *
+ * @param[in,out] cache Cache to invalidate.
+ * @param[in] process Handle to the process.
+ * @param[in] base Address of range.
+ * @param[in] size Size of range.
+ */
+void Process_cache_invalidate_range(Process_cache *cache, HANDLE process, uintptr_t base, size_t size);
+
+/**
+ * Starts new generation, so that every page cached before is read again on next use.
+ *
+ * Unlike Process_cache_invalidate() it takes constant time.
+ *
+ * @param[in,out] cache Cache to use.
+ *
+ * @return New generation.
+ */
+uint32_t Process_cache_next_generation(Process_cache *cache);
+
+/**
+ * Retrieves cache statistics.
+ *
+ * @param[in] cache Cache to inspect.
+ *
+ * @return Copy of statistics.
+ */
+Process_cache_stats Process_cache_get_stats(const Process_cache *cache);
+
+/*@}*/
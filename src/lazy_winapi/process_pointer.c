@@ -0,0 +1,193 @@
+/**
+ * @file
+ *
+ * Source code of @ref ProcessPointer module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "process_pointer.h"
+
+/** Initial size of table. */
+#define MIN_ENTRIES 1024
+/** Entry whose pointer is already read. */
+#define NOT_PENDING UINT32_MAX
+
+/**
+ * @return Position of entry if there is no collision.
+ */
+static size_t entry_home(const Process_pointer_resolver *resolver, uintptr_t address) {
+    const uint64_t key = (uint64_t)address * 0x9E3779B97F4A7C15ULL;
+
+    return (size_t)(key >> 32) & (resolver->entries_len - 1);
+}
+
+/**
+ * @return Position of entry of address or position of empty entry where it belongs.
+ */
+static size_t entry_find(const Process_pointer_resolver *resolver, uintptr_t address) {
+    const size_t mask = resolver->entries_len - 1;
+    size_t pos = entry_home(resolver, address);
+
+    for (; resolver->entries[pos].tick == resolver->tick; pos = (pos + 1) & mask) {
+        if (resolver->entries[pos].address == address) break;
+    }
+
+    return pos;
+}
+
+/**
+ * Grows table so that it stays at most half full after adding entries.
+ */
+static bool entries_reserve(Process_pointer_resolver *resolver, size_t additional) {
+    const size_t old_len = resolver->entries_len;
+    size_t len = old_len;
+
+    while ((resolver->count + additional) * 2 > len) len *= 2;
+    if (len == old_len) return true;
+
+    Process_pointer_entry *old_entries = resolver->entries;
+    Process_pointer_entry *entries = (Process_pointer_entry*)calloc(len, sizeof(*entries));
+
+    if (entries == NULL) return false;
+
+    resolver->entries = entries;
+    resolver->entries_len = len;
+
+    /* Entries of previous ticks are dropped, as they are empty anyway. */
+    for (size_t idx = 0; idx < old_len; idx++) {
+        if (old_entries[idx].tick != resolver->tick) continue;
+
+        entries[entry_find(resolver, old_entries[idx].address)] = old_entries[idx];
+    }
+
+    free(old_entries);
+    return true;
+}
+
+bool Process_pointer_init(Process_pointer_resolver *resolver, HANDLE process, size_t pointer_size) {
+    memset(resolver, 0, sizeof(*resolver));
+
+    if (pointer_size == 0) pointer_size = sizeof(void*);
+    if ((pointer_size != 4 && pointer_size != 8) || pointer_size > sizeof(uintptr_t)) return false;
+
+    resolver->entries = (Process_pointer_entry*)calloc(MIN_ENTRIES, sizeof(*resolver->entries));
+    if (resolver->entries == NULL) return false;
+
+    resolver->process = process;
+    resolver->pointer_size = pointer_size;
+    resolver->entries_len = MIN_ENTRIES;
+    /* Tick of zeroed entries is 0, so they are empty. */
+    resolver->tick = 1;
+    return true;
+}
+
+void Process_pointer_free(Process_pointer_resolver *resolver) {
+    free(resolver->entries);
+    memset(resolver, 0, sizeof(*resolver));
+}
+
+void Process_pointer_next_tick(Process_pointer_resolver *resolver) {
+    resolver->count = 0;
+
+    if (++resolver->tick == 0) {
+        memset(resolver->entries, 0, resolver->entries_len * sizeof(*resolver->entries));
+        resolver->tick = 1;
+    }
+}
+
+/**
+ * @return Whether pointer is yet to be read for path.
+ */
+static inline bool path_is_active(const Process_pointer_path *path, const Process_pointer_result *result) {
+    return result->address != 0 && result->depth + 1 < path->len;
+}
+
+size_t Process_pointer_resolve(Process_pointer_resolver *resolver, const Process_pointer_path *paths, size_t len, Process_pointer_result *results) {
+    size_t resolved = 0;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        results[idx].address = paths[idx].len > 0 ? paths[idx].base + (uintptr_t)paths[idx].offsets[0] : paths[idx].base;
+        results[idx].depth = 0;
+    }
+
+    /* Positions of entries that paths wait for, and reads of a single level. */
+    size_t *positions = (size_t*)malloc(len * sizeof(*positions));
+    Process_iovec *iovecs = (Process_iovec*)malloc(len * sizeof(*iovecs));
+    uint64_t *values = (uint64_t*)malloc(len * sizeof(*values));
+    bool *is_read = (bool*)malloc(len * sizeof(*is_read));
+    bool is_ok = len == 0 || (positions != NULL && iovecs != NULL && values != NULL && is_read != NULL);
+
+    while (is_ok) {
+        size_t active = 0;
+        size_t reads = 0;
+
+        for (size_t idx = 0; idx < len; idx++) {
+            if (path_is_active(&paths[idx], &results[idx])) active++;
+        }
+
+        if (active == 0) break;
+
+        is_ok = entries_reserve(resolver, active);
+        if (!is_ok) break;
+
+        /* Each address is read once, no matter how many paths go through it. */
+        for (size_t idx = 0; idx < len; idx++) {
+            if (!path_is_active(&paths[idx], &results[idx])) continue;
+
+            const size_t pos = entry_find(resolver, results[idx].address);
+            Process_pointer_entry *entry = &resolver->entries[pos];
+
+            if (entry->tick != resolver->tick) {
+                entry->address = results[idx].address;
+                entry->pointer = 0;
+                entry->tick = resolver->tick;
+                entry->pending = (uint32_t)reads;
+
+                values[reads] = 0;
+                iovecs[reads].base = results[idx].address;
+                iovecs[reads].buffer = (uint8_t*)&values[reads];
+                iovecs[reads].size = resolver->pointer_size;
+                reads++;
+                resolver->count++;
+            }
+
+            positions[idx] = pos;
+        }
+
+        (void)Process_read_mem_batch(resolver->process, iovecs, reads, is_read);
+
+        for (size_t idx = 0; idx < len; idx++) {
+            if (!path_is_active(&paths[idx], &results[idx])) continue;
+
+            Process_pointer_entry *entry = &resolver->entries[positions[idx]];
+
+            if (entry->pending != NOT_PENDING) {
+                /* Pointers of process are little endian, so smaller one fills lower bytes of value. */
+                entry->pointer = is_read[entry->pending] ? (uintptr_t)values[entry->pending] : 0;
+                entry->pending = NOT_PENDING;
+            }
+
+            if (entry->pointer == 0) {
+                results[idx].address = 0;
+                continue;
+            }
+
+            results[idx].depth++;
+            results[idx].address = entry->pointer + (uintptr_t)paths[idx].offsets[results[idx].depth];
+        }
+    }
+
+    free(is_read);
+    free(values);
+    free(iovecs);
+    free(positions);
+
+    for (size_t idx = 0; idx < len; idx++) {
+        if (!is_ok) results[idx].address = 0;
+        if (results[idx].address != 0) resolved++;
+    }
+
+    return resolved;
+}
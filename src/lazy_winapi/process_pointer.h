@@ -0,0 +1,168 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ProcessPointer module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "process.h"
+
+/**
+ * @addtogroup ProcessPointer
+ *
+ * Resolution of many pointer paths at once.
+ *
+ * Requires @ref Process module.
+ *
+ * Paths are resolved level by level: pointers of every path at the same depth are read at once
+ * with Process_read_mem_batch(), so that path of N levels costs N batched reads instead of N reads per path.
+ *
+ * Pointers that are read are remembered until Process_pointer_next_tick(),
+ * so paths that share prefix read it only once, and so do repeated resolutions within the same tick.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Resolve positions of players on each frame
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "process_pointer.h"
+
+    const intptr_t offsets[2][4] = {
+        {0x10, 0x8, 0x20, 0x30},
+        {0x10, 0x8, 0x28, 0x30}
+    };
+    const Process_pointer_path paths[2] = {
+        {module_base, offsets[0], 4},
+        {module_base, offsets[1], 4}
+    };
+    Process_pointer_result results[2];
+    Process_pointer_resolver resolver;
+
+    Process_pointer_init(&resolver, process, 0);
+
+    for (;;) {
+        Process_pointer_next_tick(&resolver);
+        Process_pointer_resolve(&resolver, paths, 2, results);
+
+        // Read positions at results[0].address and results[1].address
+    }
+
+    Process_pointer_free(&resolver);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Path of pointers.
+ *
+ * Address of path is base plus the first offset.
+ * Each next offset is added to pointer that is read at address of previous step.
+ * So path of N offsets reads N - 1 pointers.
+ */
+typedef struct {
+    /** Base address, usually address of module. */
+    uintptr_t base;
+    /** Offsets. */
+    const intptr_t *offsets;
+    /** Number of offsets. */
+    size_t len;
+} Process_pointer_path;
+
+/**
+ * Result of path resolution.
+ */
+typedef struct {
+    /** Resolved address. 0 if path cannot be resolved. */
+    uintptr_t address;
+    /**
+     * Number of pointers that are read.
+     * If path cannot be resolved, it is the depth at which pointer cannot be read or is NULL.
+     */
+    size_t depth;
+} Process_pointer_result;
+
+/**
+ * Remembered pointer.
+ */
+typedef struct {
+    /** Address that pointer is read from. */
+    uintptr_t address;
+    /** Pointer. 0 if it cannot be read. */
+    uintptr_t pointer;
+    /** Tick that pointer is read in. */
+    uint32_t tick;
+    /** Index of pending read in batch. */
+    uint32_t pending;
+} Process_pointer_entry;
+
+/**
+ * Resolver of pointer paths.
+ *
+ * Fields are private and should be accessed only via functions.
+ */
+typedef struct {
+    HANDLE process;
+    /** Size of pointers of process. */
+    size_t pointer_size;
+
+    /** Open addressing table of remembered pointers. */
+    Process_pointer_entry *entries;
+    /** Power of two size of table. */
+    size_t entries_len;
+    /** Number of entries of current tick. */
+    size_t count;
+
+    /** Current tick. Entries of previous ticks are empty. */
+    uint32_t tick;
+} Process_pointer_resolver;
+
+/**
+ * Initializes resolver.
+ *
+ * @param[out] resolver Resolver.
+ * @param[in] process Handle to the process.
+ * @param[in] pointer_size Size of pointers of process, 4 or 8. 0 means size of pointers of caller.
+ *
+ * @retval true On success.
+ * @retval false If size of pointers is invalid or memory cannot be allocated.
+ */
+bool Process_pointer_init(Process_pointer_resolver *resolver, HANDLE process, size_t pointer_size);
+
+/**
+ * Frees memory of resolver.
+ *
+ * @param[in,out] resolver Resolver.
+ */
+void Process_pointer_free(Process_pointer_resolver *resolver);
+
+/**
+ * Starts new tick, so that every pointer remembered before is read again on next use.
+ *
+ * Takes constant time.
+ *
+ * @param[in,out] resolver Resolver.
+ */
+void Process_pointer_next_tick(Process_pointer_resolver *resolver);
+
+/**
+ * Resolves paths.
+ *
+ * @note Requires access right PROCESS_VM_READ.
+ *
+ * @param[in,out] resolver Resolver.
+ * @param[in] paths Paths.
+ * @param[in] len Number of paths.
+ * @param[out] results Memory to hold result of each path.
+ *
+ * @return Number of resolved paths.
+ * @retval 0 If no path is resolved or memory cannot be allocated.
+ */
+size_t Process_pointer_resolve(Process_pointer_resolver *resolver, const Process_pointer_path *paths, size_t len, Process_pointer_result *results);
+
+/*@}*/
@@ -0,0 +1,223 @@
+/**
+ * @file
+ *
+ * Source code of @ref ProcessScan module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "process_scan.h"
+
+/**
+ * Part of region that is searched by single thread at once.
+ */
+typedef struct {
+    /** Address of chunk. */
+    uintptr_t base;
+    /** Number of bytes to read, including overlap with next chunk. */
+    size_t read_size;
+} scan_chunk;
+
+/**
+ * State shared by threads of scan.
+ */
+typedef struct {
+    HANDLE process;
+    const Pattern *pattern;
+    size_t chunk_size;
+
+    scan_chunk *chunks;
+    size_t chunks_len;
+    /** Number of chunks taken by threads. */
+    volatile LONG next_chunk;
+
+    /** Guards matches. */
+    CRITICAL_SECTION lock;
+    uintptr_t *matches;
+    size_t matches_len;
+    size_t matches_capacity;
+    /** Number of matches, including the ones that could not be stored. */
+    size_t total;
+} scan_job;
+
+/**
+ * Appends chunks of range of region to job.
+ */
+static bool job_add_region(scan_job *job, uintptr_t base, uintptr_t end) {
+    const size_t overlap = job->pattern->len - 1;
+
+    for (uintptr_t chunk = base; end - chunk >= job->pattern->len; chunk += job->chunk_size) {
+        const size_t rest = (size_t)(end - chunk);
+
+        if (job->chunks_len % 256 == 0) {
+            scan_chunk *chunks = (scan_chunk*)realloc(job->chunks, (job->chunks_len + 256) * sizeof(*chunks));
+
+            if (chunks == NULL) return false;
+            job->chunks = chunks;
+        }
+
+        scan_chunk *next = &job->chunks[job->chunks_len++];
+
+        next->base = chunk;
+        next->read_size = rest < job->chunk_size + overlap ? rest : job->chunk_size + overlap;
+
+        if (rest <= job->chunk_size + overlap) break;
+    }
+
+    return true;
+}
+
+/**
+ * Stores matches of single chunk.
+ */
+static void job_add_matches(scan_job *job, const uintptr_t *matches, size_t len) {
+    EnterCriticalSection(&job->lock);
+
+    job->total += len;
+
+    if (job->matches_len + len > job->matches_capacity) {
+        size_t capacity = job->matches_capacity ? job->matches_capacity * 2 : 64;
+
+        while (capacity < job->matches_len + len) capacity *= 2;
+
+        uintptr_t *grown = (uintptr_t*)realloc(job->matches, capacity * sizeof(*grown));
+
+        if (grown != NULL) {
+            job->matches = grown;
+            job->matches_capacity = capacity;
+        }
+    }
+
+    if (job->matches_len + len <= job->matches_capacity) {
+        memcpy(job->matches + job->matches_len, matches, len * sizeof(*matches));
+        job->matches_len += len;
+    }
+
+    LeaveCriticalSection(&job->lock);
+}
+
+/**
+ * Thread of scan that takes chunks until there are none.
+ */
+static DWORD WINAPI scan_thread(LPVOID param) {
+    scan_job *job = (scan_job*)param;
+    const Pattern *pattern = job->pattern;
+    uint8_t *buffer = (uint8_t*)malloc(job->chunk_size + pattern->len - 1);
+    uintptr_t matches[64];
+
+    if (buffer == NULL) return 1;
+
+    for (;;) {
+        const size_t idx = (size_t)InterlockedIncrement(&job->next_chunk) - 1;
+
+        if (idx >= job->chunks_len) break;
+
+        const scan_chunk *chunk = &job->chunks[idx];
+        size_t matches_len = 0;
+
+        if (Process_read_mem(job->process, chunk->base, buffer, chunk->read_size) == NULL) continue;
+
+        /* Overlap is shorter than pattern, so matches that start in it are left to next chunk. */
+        for (const uint8_t *found = Pattern_find(pattern, buffer, chunk->read_size);
+             found != NULL;
+             found = Pattern_find(pattern, found + 1, chunk->read_size - (size_t)(found + 1 - buffer))) {
+            if (matches_len == sizeof(matches) / sizeof(matches[0])) {
+                job_add_matches(job, matches, matches_len);
+                matches_len = 0;
+            }
+
+            matches[matches_len++] = chunk->base + (uintptr_t)(found - buffer);
+        }
+
+        if (matches_len > 0) job_add_matches(job, matches, matches_len);
+    }
+
+    free(buffer);
+    return 0;
+}
+
+static int address_cmp(const void *left, const void *right) {
+    const uintptr_t left_address = *(const uintptr_t*)left;
+    const uintptr_t right_address = *(const uintptr_t*)right;
+
+    return (left_address > right_address) - (left_address < right_address);
+}
+
+size_t Process_scan(HANDLE process, const Pattern *pattern, const Process_scan_options *options, uintptr_t *results, size_t len) {
+    const Process_scan_options defaults = {0};
+    Process_region_iter iter;
+    Process_region region;
+    scan_job job;
+    size_t threads;
+
+    if (options == NULL) options = &defaults;
+
+    memset(&job, 0, sizeof(job));
+    job.process = process;
+    job.pattern = pattern;
+    job.chunk_size = options->chunk_size ? options->chunk_size : PROCESS_SCAN_CHUNK_SIZE;
+
+    const uintptr_t start = options->start;
+    const uintptr_t end = options->end ? options->end : UINTPTR_MAX;
+
+    /*
+     * Adjacent regions with the same state, protection and type are coalesced, so matches across their boundaries are found.
+     * Matches across boundaries of regions that differ in any of them are not found.
+     */
+    Process_region_iter_init(&iter, process, options->region_flags | PROCESS_REGION_READABLE | PROCESS_REGION_COALESCE);
+
+    while (Process_region_iter_next(&iter, &region)) {
+        const uintptr_t region_end = region.base + region.size;
+
+        if (region_end <= start) continue;
+        if (region.base >= end) break;
+
+        if (!job_add_region(&job, region.base > start ? region.base : start, region_end < end ? region_end : end)) {
+            free(job.chunks);
+            return 0;
+        }
+    }
+
+    if (options->threads) {
+        threads = options->threads;
+    }
+    else {
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+        threads = info.dwNumberOfProcessors;
+    }
+
+    if (threads > job.chunks_len) threads = job.chunks_len;
+
+    InitializeCriticalSection(&job.lock);
+
+    HANDLE *handles = threads > 1 ? (HANDLE*)calloc(threads - 1, sizeof(*handles)) : NULL;
+
+    /* Caller's thread works too, so scan goes on even if no thread can be started. */
+    for (size_t idx = 0; handles != NULL && idx < threads - 1; idx++) {
+        handles[idx] = CreateThread(NULL, 0, scan_thread, &job, 0, NULL);
+    }
+
+    (void)scan_thread(&job);
+
+    for (size_t idx = 0; handles != NULL && idx < threads - 1; idx++) {
+        if (handles[idx] == NULL) continue;
+
+        (void)WaitForSingleObject(handles[idx], INFINITE);
+        (void)CloseHandle(handles[idx]);
+    }
+
+    free(handles);
+    DeleteCriticalSection(&job.lock);
+
+    if (job.matches_len > 0) {
+        qsort(job.matches, job.matches_len, sizeof(*job.matches), address_cmp);
+        if (len > 0) memcpy(results, job.matches, (len < job.matches_len ? len : job.matches_len) * sizeof(*results));
+    }
+
+    free(job.matches);
+    free(job.chunks);
+    return job.total;
+}
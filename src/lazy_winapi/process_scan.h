@@ -0,0 +1,91 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ProcessScan module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "pattern.h"
+#include "process.h"
+
+/**
+ * @addtogroup ProcessScan
+ *
+ * Multithreaded search of byte patterns in memory of process.
+ *
+ * Requires @ref Process and @ref Pattern modules.
+ *
+ * Readable regions of process are split into chunks that overlap by length of pattern minus one,
+ * so that matches across chunk boundaries are found exactly once.
+ * Adjacent regions are merged only if they have the same state, protection and type,
+ * so matches across boundaries of other regions are not found.
+ * Chunks are shared between pool of threads, each reading chunk into its own buffer and
+ * searching it with Pattern_find(), so that reads of some threads overlap searches of others.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Find signature in process
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "process_scan.h"
+
+    Pattern pattern;
+    uintptr_t matches[16];
+
+    Pattern_compile(&pattern, "48 8B 05 ?? ?? ?? ?? E8");
+
+    const size_t count = Process_scan(process, &pattern, NULL, matches, 16);
+
+    for (size_t idx = 0; idx < count && idx < 16; idx++) {
+        printf("Match at address=%p\n", (void*)matches[idx]);
+    }
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Default size of chunk.
+ */
+#define PROCESS_SCAN_CHUNK_SIZE (1024 * 1024)
+
+/**
+ * Options of scan. Zero initialized options scan every readable region with default settings.
+ */
+typedef struct {
+    /** Number of threads including caller's. 0 means number of processors. */
+    size_t threads;
+    /** Size of chunk. 0 means PROCESS_SCAN_CHUNK_SIZE. */
+    size_t chunk_size;
+    /** Start of range of addresses to scan. */
+    uintptr_t start;
+    /** End of range of addresses to scan. 0 means end of address space. */
+    uintptr_t end;
+    /** Filters of regions as `PROCESS_REGION_*` flags. Readable regions are always required. */
+    unsigned region_flags;
+} Process_scan_options;
+
+/**
+ * Finds every match of pattern in memory of process.
+ *
+ * Chunks that cannot be read, for example because memory was freed during scan, are skipped.
+ *
+ * @note Requires access rights PROCESS_VM_READ and PROCESS_QUERY_INFORMATION or PROCESS_QUERY_LIMITED_INFORMATION.
+ *
+ * @param[in] process Handle to the process.
+ * @param[in] pattern Compiled pattern.
+ * @param[in] options Options. If NULL, defaults are used.
+ * @param[out] results Memory to hold the lowest addresses of matches in ascending order.
+ * @param[in] len Number of elements in results.
+ *
+ * @return Number of matches, which can be bigger than len.
+ * @retval 0 If there are no matches or memory for scan cannot be allocated.
+ */
+size_t Process_scan(HANDLE process, const Pattern *pattern, const Process_scan_options *options, uintptr_t *results, size_t len);
+
+/*@}*/
@@ -0,0 +1,530 @@
+/**
+ * @file
+ *
+ * Source code of @ref ProcessSearch module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "process_search.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SEARCH_SSE2
+#endif
+
+#define PAGE_MASK ((uintptr_t)PROCESS_SEARCH_PAGE_SIZE - 1)
+/** Number of pages read at once. */
+#define BATCH_PAGES 256
+/** Maximum number of slots in page. */
+#define MAX_SLOTS PROCESS_SEARCH_PAGE_SIZE
+
+/**
+ * Comparison of current value with operand or previous value.
+ */
+typedef enum {
+    RELATION_EQ,
+    RELATION_NE,
+    RELATION_LT,
+    RELATION_GT
+} relation;
+
+/**
+ * Scratch memory of single pass.
+ */
+typedef struct {
+    /** Pages that are read at once. */
+    uint8_t pages[BATCH_PAGES * PROCESS_SEARCH_PAGE_SIZE];
+    Process_iovec iovecs[BATCH_PAGES];
+    bool results[BATCH_PAGES];
+
+    /** Slots of candidates of page. */
+    uint16_t slots[MAX_SLOTS];
+    /** Slots of candidates that pass comparison. */
+    uint16_t kept_slots[MAX_SLOTS];
+    /** Values of candidates of page. */
+    uint8_t values[MAX_SLOTS * sizeof(int64_t)];
+    /** Values of candidates that pass comparison. */
+    uint8_t kept_values[MAX_SLOTS * sizeof(int64_t)];
+    /** Results of comparison. */
+    uint64_t bits[MAX_SLOTS / 64];
+} search_scratch;
+
+/**
+ * @return Index of the lowest set bit in non-zero mask.
+ */
+static inline unsigned first_bit64(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long result;
+    (void)_BitScanForward64(&result, mask);
+    return (unsigned)result;
+#elif defined(_MSC_VER)
+    unsigned long result;
+    if ((uint32_t)mask != 0) {
+        (void)_BitScanForward(&result, (uint32_t)mask);
+        return (unsigned)result;
+    }
+    (void)_BitScanForward(&result, (uint32_t)(mask >> 32));
+    return (unsigned)result + 32;
+#else
+    return (unsigned)__builtin_ctzll(mask);
+#endif
+}
+
+static size_t value_size(Process_value_type type) {
+    switch (type) {
+        case PROCESS_VALUE_I8: return 1;
+        case PROCESS_VALUE_I16: return 2;
+        case PROCESS_VALUE_I32: return 4;
+        case PROCESS_VALUE_F32: return 4;
+        default: return 8;
+    }
+}
+
+/**
+ * Compares values using scalar code, starting at idx.
+ */
+#define SCALAR_COMPARE(type_, member_) \
+    for (; idx < count; idx++) { \
+        type_ left; \
+        type_ right = operand->member_; \
+        bool is_pass; \
+        memcpy(&left, current + idx * sizeof(type_), sizeof(type_)); \
+        if (previous) memcpy(&right, previous + idx * sizeof(type_), sizeof(type_)); \
+        switch (rel) { \
+            case RELATION_EQ: is_pass = left == right; break; \
+            case RELATION_NE: is_pass = left != right; break; \
+            case RELATION_LT: is_pass = left < right; break; \
+            default: is_pass = left > right; break; \
+        } \
+        if (is_pass) bits[idx / 64] |= (uint64_t)1 << (idx % 64); \
+    }
+
+#if defined(SEARCH_SSE2)
+/**
+ * Compares 16 bytes of integers at a time, starting at idx.
+ */
+#define SSE2_INT_COMPARE(lanes_, set1_, cmpeq_, cmpgt_, movemask_) \
+    for (const __m128i operand_sse = set1_; idx + lanes_ <= count; idx += lanes_) { \
+        const __m128i left = _mm_loadu_si128((const __m128i*)(current + idx * (16 / lanes_))); \
+        const __m128i right = previous ? _mm_loadu_si128((const __m128i*)(previous + idx * (16 / lanes_))) : operand_sse; \
+        __m128i result; \
+        switch (rel) { \
+            case RELATION_EQ: result = cmpeq_(left, right); break; \
+            case RELATION_NE: result = _mm_xor_si128(cmpeq_(left, right), _mm_set1_epi32(-1)); break; \
+            case RELATION_LT: result = cmpgt_(right, left); break; \
+            default: result = cmpgt_(left, right); break; \
+        } \
+        bits[idx / 64] |= (uint64_t)(movemask_) << (idx % 64); \
+    }
+
+/**
+ * Compares 16 bytes of floating point numbers at a time, starting at idx.
+ */
+#define SSE2_FLOAT_COMPARE(lanes_, type_, load_, set1_, cmpeq_, cmpneq_, cmplt_, cmpgt_, movemask_) \
+    for (const type_ operand_sse = set1_; idx + lanes_ <= count; idx += lanes_) { \
+        const type_ left = load_(current + idx * (16 / lanes_)); \
+        const type_ right = previous ? load_(previous + idx * (16 / lanes_)) : operand_sse; \
+        type_ result; \
+        switch (rel) { \
+            case RELATION_EQ: result = cmpeq_(left, right); break; \
+            case RELATION_NE: result = cmpneq_(left, right); break; \
+            case RELATION_LT: result = cmplt_(left, right); break; \
+            default: result = cmpgt_(left, right); break; \
+        } \
+        bits[idx / 64] |= (uint64_t)movemask_(result) << (idx % 64); \
+    }
+
+static inline __m128 load_ps(const uint8_t *ptr) {
+    return _mm_loadu_ps((const float*)ptr);
+}
+
+static inline __m128d load_pd(const uint8_t *ptr) {
+    return _mm_loadu_pd((const double*)ptr);
+}
+#endif
+
+/**
+ * Compares count values with operand or previous values.
+ *
+ * @param[in] current Current values.
+ * @param[in] previous Previous values. If NULL, current values are compared with operand.
+ * @param[out] bits Bit for each value that passes comparison. Must be zeroed.
+ */
+static void compare_values(Process_value_type type, relation rel, const uint8_t *current, const uint8_t *previous,
+                           const Process_value *operand, size_t count, uint64_t *bits) {
+    size_t idx = 0;
+
+    switch (type) {
+        case PROCESS_VALUE_I8:
+#if defined(SEARCH_SSE2)
+            SSE2_INT_COMPARE(16, _mm_set1_epi8(operand->i8), _mm_cmpeq_epi8, _mm_cmpgt_epi8,
+                             (uint32_t)_mm_movemask_epi8(result))
+#endif
+            SCALAR_COMPARE(int8_t, i8)
+            break;
+        case PROCESS_VALUE_I16:
+#if defined(SEARCH_SSE2)
+            /* Packing keeps sign of each result, so that byte mask holds bit per value. */
+            SSE2_INT_COMPARE(8, _mm_set1_epi16(operand->i16), _mm_cmpeq_epi16, _mm_cmpgt_epi16,
+                             (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(result, _mm_setzero_si128())))
+#endif
+            SCALAR_COMPARE(int16_t, i16)
+            break;
+        case PROCESS_VALUE_I32:
+#if defined(SEARCH_SSE2)
+            SSE2_INT_COMPARE(4, _mm_set1_epi32(operand->i32), _mm_cmpeq_epi32, _mm_cmpgt_epi32,
+                             (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(result)))
+#endif
+            SCALAR_COMPARE(int32_t, i32)
+            break;
+        case PROCESS_VALUE_I64:
+            /* SSE2 has no comparison of 64 bit integers. */
+            SCALAR_COMPARE(int64_t, i64)
+            break;
+        case PROCESS_VALUE_F32:
+#if defined(SEARCH_SSE2)
+            SSE2_FLOAT_COMPARE(4, __m128, load_ps, _mm_set1_ps(operand->f32),
+                               _mm_cmpeq_ps, _mm_cmpneq_ps, _mm_cmplt_ps, _mm_cmpgt_ps, (uint32_t)_mm_movemask_ps)
+#endif
+            SCALAR_COMPARE(float, f32)
+            break;
+        case PROCESS_VALUE_F64:
+#if defined(SEARCH_SSE2)
+            SSE2_FLOAT_COMPARE(2, __m128d, load_pd, _mm_set1_pd(operand->f64),
+                               _mm_cmpeq_pd, _mm_cmpneq_pd, _mm_cmplt_pd, _mm_cmpgt_pd, (uint32_t)_mm_movemask_pd)
+#endif
+            SCALAR_COMPARE(double, f64)
+            break;
+    }
+}
+
+/**
+ * Appends size bytes to buffer.
+ *
+ * @return Appended memory or NULL on failure.
+ */
+static uint8_t* buffer_append(Process_search_buffer *buffer, size_t size) {
+    if (buffer->len + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+
+        while (capacity < buffer->len + size) capacity *= 2;
+
+        uint8_t *data = (uint8_t*)realloc(buffer->data, capacity);
+
+        if (data == NULL) return NULL;
+
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    uint8_t *result = buffer->data + buffer->len;
+
+    buffer->len += size;
+    return result;
+}
+
+/**
+ * @return Number of slots in page.
+ */
+static size_t search_slots(const Process_search *search) {
+    return (PROCESS_SEARCH_PAGE_SIZE - search->size) / search->options.alignment + 1;
+}
+
+/**
+ * Stores candidates of page.
+ *
+ * @param[in] slots Slots of candidates in ascending order.
+ * @param[in] values Values of candidates.
+ * @param[in] count Number of candidates.
+ */
+static bool search_add_page(Process_search *search, uintptr_t base, const uint16_t *slots, const uint8_t *values, size_t count) {
+    const size_t bitmap_size = (search_slots(search) + 7) / 8;
+    const bool is_bitmap = bitmap_size < count * sizeof(*slots);
+
+    if (count == 0) return true;
+
+    if (search->pages_len == search->pages_capacity) {
+        const size_t capacity = search->pages_capacity ? search->pages_capacity * 2 : 256;
+        Process_search_page *pages = (Process_search_page*)realloc(search->pages, capacity * sizeof(*pages));
+
+        if (pages == NULL) return false;
+
+        search->pages = pages;
+        search->pages_capacity = capacity;
+    }
+
+    Process_search_page *page = &search->pages[search->pages_len];
+    const size_t index_size = is_bitmap ? bitmap_size : count * sizeof(*slots);
+    uint8_t *index = buffer_append(&search->index, index_size);
+    uint8_t *page_values = index ? buffer_append(&search->values, count * search->size) : NULL;
+
+    if (page_values == NULL) return false;
+
+    page->base = base;
+    page->count = count;
+    page->is_bitmap = is_bitmap;
+    page->index = (size_t)(index - search->index.data);
+    page->values = (size_t)(page_values - search->values.data);
+
+    if (is_bitmap) {
+        memset(index, 0, bitmap_size);
+        for (size_t idx = 0; idx < count; idx++) index[slots[idx] / 8] |= (uint8_t)(1 << (slots[idx] % 8));
+    }
+    else {
+        memcpy(index, slots, index_size);
+    }
+
+    memcpy(page_values, values, count * search->size);
+
+    search->pages_len++;
+    search->count += count;
+    return true;
+}
+
+/**
+ * Retrieves slots of candidates of page.
+ */
+static void search_page_slots(const Process_search *search, const Process_search_page *page, uint16_t *slots) {
+    const uint8_t *index = search->index.data + page->index;
+
+    if (!page->is_bitmap) {
+        memcpy(slots, index, page->count * sizeof(*slots));
+        return;
+    }
+
+    for (size_t slot = 0, idx = 0; idx < page->count; slot++) {
+        if (index[slot / 8] & (1 << (slot % 8))) slots[idx++] = (uint16_t)slot;
+    }
+}
+
+/**
+ * Copies values of slots out of page.
+ */
+static void gather_values(const Process_search *search, const uint8_t *page, const uint16_t *slots, size_t count, uint8_t *values) {
+    for (size_t idx = 0; idx < count; idx++) {
+        memcpy(values + idx * search->size, page + (size_t)slots[idx] * search->options.alignment, search->size);
+    }
+}
+
+/**
+ * Compares values of candidates of page and stores the ones that pass.
+ */
+static bool search_filter_page(Process_search *next, search_scratch *scratch, uintptr_t base, size_t count,
+                               const uint8_t *previous, relation rel, const Process_value *operand) {
+    size_t kept = 0;
+
+    memset(scratch->bits, 0, (count + 63) / 64 * sizeof(*scratch->bits));
+    compare_values(next->type, rel, scratch->values, previous, operand, count, scratch->bits);
+
+    for (size_t word = 0; word < (count + 63) / 64; word++) {
+        for (uint64_t bits = scratch->bits[word]; bits != 0; bits &= bits - 1) {
+            const size_t idx = word * 64 + first_bit64(bits);
+
+            scratch->kept_slots[kept] = scratch->slots[idx];
+            memcpy(scratch->kept_values + kept * next->size, scratch->values + idx * next->size, next->size);
+            kept++;
+        }
+    }
+
+    return search_add_page(next, base, scratch->kept_slots, scratch->kept_values, kept);
+}
+
+/**
+ * Maps comparison to relation.
+ *
+ * @return Whether comparison is with previous value.
+ */
+static bool cmp_relation(Process_search_cmp cmp, relation *rel) {
+    switch (cmp) {
+        case PROCESS_SEARCH_EQUAL: *rel = RELATION_EQ; return false;
+        case PROCESS_SEARCH_NOT_EQUAL: *rel = RELATION_NE; return false;
+        case PROCESS_SEARCH_LESS: *rel = RELATION_LT; return false;
+        case PROCESS_SEARCH_GREATER: *rel = RELATION_GT; return false;
+        case PROCESS_SEARCH_UNCHANGED: *rel = RELATION_EQ; return true;
+        case PROCESS_SEARCH_CHANGED: *rel = RELATION_NE; return true;
+        case PROCESS_SEARCH_DECREASED: *rel = RELATION_LT; return true;
+        default: *rel = RELATION_GT; return true;
+    }
+}
+
+/**
+ * Replaces candidates of search with the ones of next.
+ */
+static void search_replace(Process_search *search, Process_search *next) {
+    free(search->pages);
+    free(search->index.data);
+    free(search->values.data);
+    *search = *next;
+}
+
+/**
+ * @return Empty search with the same settings.
+ */
+static Process_search search_empty(const Process_search *search) {
+    Process_search result;
+
+    memset(&result, 0, sizeof(result));
+    result.process = search->process;
+    result.type = search->type;
+    result.options = search->options;
+    result.size = search->size;
+    return result;
+}
+
+bool Process_search_init(Process_search *search, HANDLE process, Process_value_type type, const Process_search_options *options) {
+    memset(search, 0, sizeof(*search));
+
+    search->process = process;
+    search->type = type;
+    search->size = value_size(type);
+    if (options) search->options = *options;
+    if (search->options.alignment == 0) search->options.alignment = search->size;
+
+    const size_t alignment = search->options.alignment;
+
+    return (alignment & (alignment - 1)) == 0 && alignment <= PROCESS_SEARCH_PAGE_SIZE;
+}
+
+void Process_search_free(Process_search *search) {
+    Process_search empty = search_empty(search);
+
+    search_replace(search, &empty);
+}
+
+bool Process_search_first(Process_search *search, Process_search_cmp cmp, Process_value operand) {
+    const uintptr_t start = search->options.start & ~PAGE_MASK;
+    const uintptr_t end = search->options.end ? search->options.end : UINTPTR_MAX;
+    const size_t slots = search_slots(search);
+    search_scratch *scratch;
+    Process_region_iter iter;
+    Process_region region;
+    relation rel;
+
+    if (cmp_relation(cmp, &rel)) return false;
+    if ((scratch = (search_scratch*)malloc(sizeof(*scratch))) == NULL) return false;
+
+    Process_search next = search_empty(search);
+
+    for (size_t idx = 0; idx < slots; idx++) scratch->slots[idx] = (uint16_t)idx;
+
+    Process_region_iter_init(&iter, search->process, search->options.region_flags | PROCESS_REGION_READABLE | PROCESS_REGION_COALESCE);
+
+    while (Process_region_iter_next(&iter, &region)) {
+        const uintptr_t region_end = region.base + region.size;
+        uintptr_t page = region.base > start ? region.base : start;
+
+        if (region_end <= start) continue;
+        if (region.base >= end) break;
+
+        while (page < region_end && page < end) {
+            size_t len = 0;
+
+            for (; len < BATCH_PAGES && page < region_end && page < end; len++, page += PROCESS_SEARCH_PAGE_SIZE) {
+                scratch->iovecs[len] = (Process_iovec){page, scratch->pages + len * PROCESS_SEARCH_PAGE_SIZE, PROCESS_SEARCH_PAGE_SIZE};
+            }
+
+            (void)Process_read_mem_batch(search->process, scratch->iovecs, len, scratch->results);
+
+            for (size_t idx = 0; idx < len; idx++) {
+                if (!scratch->results[idx]) continue;
+
+                if (search->options.alignment == search->size) {
+                    /* Every value of page is a slot. */
+                    memcpy(scratch->values, scratch->iovecs[idx].buffer, PROCESS_SEARCH_PAGE_SIZE);
+                }
+                else {
+                    gather_values(search, scratch->iovecs[idx].buffer, scratch->slots, slots, scratch->values);
+                }
+
+                if (!search_filter_page(&next, scratch, scratch->iovecs[idx].base, slots, NULL, rel, &operand)) {
+                    Process_search_free(&next);
+                    free(scratch);
+                    return false;
+                }
+            }
+        }
+    }
+
+    free(scratch);
+    search_replace(search, &next);
+    return true;
+}
+
+bool Process_search_next(Process_search *search, Process_search_cmp cmp, Process_value operand) {
+    search_scratch *scratch = (search_scratch*)malloc(sizeof(*scratch));
+    relation rel;
+    const bool is_relative = cmp_relation(cmp, &rel);
+
+    if (scratch == NULL) return false;
+
+    Process_search next = search_empty(search);
+
+    for (size_t batch = 0; batch < search->pages_len; batch += BATCH_PAGES) {
+        const size_t len = search->pages_len - batch < BATCH_PAGES ? search->pages_len - batch : BATCH_PAGES;
+
+        for (size_t idx = 0; idx < len; idx++) {
+            scratch->iovecs[idx] = (Process_iovec){search->pages[batch + idx].base, scratch->pages + idx * PROCESS_SEARCH_PAGE_SIZE, PROCESS_SEARCH_PAGE_SIZE};
+        }
+
+        (void)Process_read_mem_batch(search->process, scratch->iovecs, len, scratch->results);
+
+        for (size_t idx = 0; idx < len; idx++) {
+            const Process_search_page *page = &search->pages[batch + idx];
+
+            if (!scratch->results[idx]) continue;
+
+            search_page_slots(search, page, scratch->slots);
+            gather_values(search, scratch->iovecs[idx].buffer, scratch->slots, page->count, scratch->values);
+
+            if (!search_filter_page(&next, scratch, page->base, page->count,
+                                    is_relative ? search->values.data + page->values : NULL, rel, &operand)) {
+                Process_search_free(&next);
+                free(scratch);
+                return false;
+            }
+        }
+    }
+
+    free(scratch);
+    search_replace(search, &next);
+    return true;
+}
+
+size_t Process_search_count(const Process_search *search) {
+    return search->count;
+}
+
+size_t Process_search_get(const Process_search *search, size_t skip, uintptr_t *addresses, Process_value *values, size_t len) {
+    uint16_t slots[MAX_SLOTS];
+    size_t result = 0;
+
+    for (size_t page_idx = 0; page_idx < search->pages_len && result < len; page_idx++) {
+        const Process_search_page *page = &search->pages[page_idx];
+
+        if (skip >= page->count) {
+            skip -= page->count;
+            continue;
+        }
+
+        search_page_slots(search, page, slots);
+
+        for (size_t idx = skip; idx < page->count && result < len; idx++, result++) {
+            addresses[result] = page->base + (uintptr_t)slots[idx] * search->options.alignment;
+
+            if (values) {
+                memset(&values[result], 0, sizeof(values[result]));
+                memcpy(&values[result], search->values.data + page->values + idx * search->size, search->size);
+            }
+        }
+
+        skip = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,241 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ProcessSearch module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "process.h"
+
+/**
+ * @addtogroup ProcessSearch
+ *
+ * Incremental search of values in memory of process, narrowing candidates on each pass.
+ *
+ * Requires @ref Process module.
+ *
+ * The first pass reads every readable region and keeps addresses whose value passes comparison.
+ * Each next pass re-reads only pages that still hold candidates, many pages at once with Process_read_mem_batch(),
+ * and keeps candidates whose value passes comparison with operand or with value of previous pass.
+ *
+ * Candidates are kept per page of PROCESS_SEARCH_PAGE_SIZE, either as bitmap of slots or as list of offsets,
+ * whichever is smaller, along with their values from the last pass.
+ * Values are compared with SSE2 when compiler targets it.
+ *
+ * @note Values that cross boundary of page are not searched.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Find health that has just decreased
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "process_search.h"
+
+    Process_search search;
+    Process_value value = {.i32 = 100};
+    uintptr_t address;
+
+    Process_search_init(&search, process, PROCESS_VALUE_I32, NULL);
+    Process_search_first(&search, PROCESS_SEARCH_EQUAL, value);
+
+    // Take damage
+    Process_search_next(&search, PROCESS_SEARCH_DECREASED, value);
+
+    if (Process_search_count(&search) == 1) {
+        Process_search_get(&search, 0, &address, NULL, 1);
+    }
+
+    Process_search_free(&search);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Granularity of candidates.
+ */
+#define PROCESS_SEARCH_PAGE_SIZE 4096
+
+/**
+ * Type of searched value.
+ */
+typedef enum {
+    PROCESS_VALUE_I8,
+    PROCESS_VALUE_I16,
+    PROCESS_VALUE_I32,
+    PROCESS_VALUE_I64,
+    PROCESS_VALUE_F32,
+    PROCESS_VALUE_F64
+} Process_value_type;
+
+/**
+ * Value of any type. Member is chosen by Process_value_type.
+ */
+typedef union {
+    int8_t i8;
+    int16_t i16;
+    int32_t i32;
+    int64_t i64;
+    float f32;
+    double f64;
+} Process_value;
+
+/**
+ * Comparison of value in memory.
+ */
+typedef enum {
+    /** Equal to operand. */
+    PROCESS_SEARCH_EQUAL,
+    /** Not equal to operand. */
+    PROCESS_SEARCH_NOT_EQUAL,
+    /** Less than operand. */
+    PROCESS_SEARCH_LESS,
+    /** Greater than operand. */
+    PROCESS_SEARCH_GREATER,
+    /** Equal to value of previous pass. Operand is ignored. */
+    PROCESS_SEARCH_UNCHANGED,
+    /** Not equal to value of previous pass. Operand is ignored. */
+    PROCESS_SEARCH_CHANGED,
+    /** Less than value of previous pass. Operand is ignored. */
+    PROCESS_SEARCH_DECREASED,
+    /** Greater than value of previous pass. Operand is ignored. */
+    PROCESS_SEARCH_INCREASED
+} Process_search_cmp;
+
+/**
+ * Options of search. Zero initialized options search every readable region.
+ *
+ * Range of addresses is extended to whole pages.
+ */
+typedef struct {
+    /** Start of range of addresses to search. */
+    uintptr_t start;
+    /** End of range of addresses to search. 0 means end of address space. */
+    uintptr_t end;
+    /** Filters of regions as `PROCESS_REGION_*` flags. Readable regions are always required. */
+    unsigned region_flags;
+    /** Alignment of values, power of two no bigger than page. 0 means size of value. */
+    size_t alignment;
+} Process_search_options;
+
+/**
+ * Candidates of single page.
+ */
+typedef struct {
+    /** Address of page. */
+    uintptr_t base;
+    /** Number of candidates. */
+    size_t count;
+    /** Whether candidates are stored as bitmap of slots instead of offsets. */
+    bool is_bitmap;
+    /** Offset of bitmap or offsets in index of search. */
+    size_t index;
+    /** Offset of values in values of search. */
+    size_t values;
+} Process_search_page;
+
+/**
+ * Growable memory of search.
+ */
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t capacity;
+} Process_search_buffer;
+
+/**
+ * Search session.
+ *
+ * Fields are private and should be accessed only via functions.
+ */
+typedef struct {
+    HANDLE process;
+    Process_value_type type;
+    Process_search_options options;
+    /** Size of value. */
+    size_t size;
+    /** Total number of candidates. */
+    size_t count;
+
+    /** Pages with candidates in order of addresses. */
+    Process_search_page *pages;
+    size_t pages_len;
+    size_t pages_capacity;
+    /** Bitmaps and offsets of candidates. */
+    Process_search_buffer index;
+    /** Values of candidates. */
+    Process_search_buffer values;
+} Process_search;
+
+/**
+ * Initializes search without candidates.
+ *
+ * @param[out] search Search.
+ * @param[in] process Handle to the process.
+ * @param[in] type Type of values.
+ * @param[in] options Options. If NULL, defaults are used.
+ *
+ * @retval true On success.
+ * @retval false If alignment is invalid.
+ */
+bool Process_search_init(Process_search *search, HANDLE process, Process_value_type type, const Process_search_options *options);
+
+/**
+ * Frees memory of search.
+ *
+ * @param[in,out] search Search.
+ */
+void Process_search_free(Process_search *search);
+
+/**
+ * Searches every readable region, replacing current candidates.
+ *
+ * @note Requires access rights PROCESS_VM_READ and PROCESS_QUERY_INFORMATION or PROCESS_QUERY_LIMITED_INFORMATION.
+ *
+ * @param[in,out] search Search.
+ * @param[in] cmp Comparison with operand. Comparisons with previous pass are not allowed.
+ * @param[in] operand Operand of comparison.
+ *
+ * @retval true On success.
+ * @retval false If comparison is not allowed or memory cannot be allocated.
+ */
+bool Process_search_first(Process_search *search, Process_search_cmp cmp, Process_value operand);
+
+/**
+ * Narrows candidates to the ones whose current value passes comparison.
+ *
+ * Candidates in pages that cannot be read anymore are dropped.
+ *
+ * @param[in,out] search Search.
+ * @param[in] cmp Comparison.
+ * @param[in] operand Operand of comparison.
+ *
+ * @retval true On success.
+ * @retval false If memory cannot be allocated. Candidates are left unchanged.
+ */
+bool Process_search_next(Process_search *search, Process_search_cmp cmp, Process_value operand);
+
+/**
+ * @return Number of candidates.
+ */
+size_t Process_search_count(const Process_search *search);
+
+/**
+ * Retrieves candidates in order of addresses.
+ *
+ * @param[in] search Search.
+ * @param[in] skip Number of candidates to skip.
+ * @param[out] addresses Memory to hold addresses of candidates.
+ * @param[out] values Optional memory to hold values of candidates as of the last pass.
+ * @param[in] len Number of elements in addresses and values.
+ *
+ * @return Number of retrieved candidates.
+ */
+size_t Process_search_get(const Process_search *search, size_t skip, uintptr_t *addresses, Process_value *values, size_t len);
+
+/*@}*/
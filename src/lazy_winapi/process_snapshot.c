@@ -0,0 +1,537 @@
+/**
+ * @file
+ *
+ * Source code of @ref ProcessSnapshot module.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "process_snapshot.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define SNAPSHOT_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define SNAPSHOT_SSE2
+#endif
+
+#define PAGE_MASK ((uintptr_t)PROCESS_SNAPSHOT_PAGE_SIZE - 1)
+/** Size of block that is compared at once. */
+#define BLOCK_SIZE 64
+/** "LWSS" */
+#define SNAPSHOT_MAGIC 0x5353574Cu
+#define SNAPSHOT_VERSION 1
+
+/**
+ * Header of snapshot file.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    /** Number of stored pages. */
+    uint64_t data_pages;
+    uint64_t regions_offset;
+    uint64_t regions_len;
+    uint64_t pages_offset;
+    uint64_t pages_len;
+} snapshot_header;
+
+/**
+ * State of snapshot that is being taken.
+ */
+typedef struct {
+    HANDLE file;
+    uint64_t data_pages;
+
+    Process_snapshot_region *regions;
+    size_t regions_len;
+    size_t regions_capacity;
+
+    uint32_t *pages;
+    size_t pages_len;
+    size_t pages_capacity;
+
+    /** Pages that are read and written at once. */
+    uint8_t buffer[PROCESS_SNAPSHOT_CHUNK_PAGES * PROCESS_SNAPSHOT_PAGE_SIZE];
+} snapshot_writer;
+
+/**
+ * Changed ranges that are found so far.
+ */
+typedef struct {
+    Process_snapshot_range *ranges;
+    size_t len;
+    /** Number of ranges, including the ones that could not be stored. */
+    size_t count;
+    /** End of the last range. */
+    uintptr_t end;
+} snapshot_diff;
+
+static const uint8_t zero_page[PROCESS_SNAPSHOT_PAGE_SIZE];
+
+/**
+ * @return Index of the lowest set bit in non-zero mask.
+ */
+static inline unsigned first_bit64(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long result;
+    (void)_BitScanForward64(&result, mask);
+    return (unsigned)result;
+#elif defined(_MSC_VER)
+    unsigned long result;
+    if ((uint32_t)mask != 0) {
+        (void)_BitScanForward(&result, (uint32_t)mask);
+        return (unsigned)result;
+    }
+    (void)_BitScanForward(&result, (uint32_t)(mask >> 32));
+    return (unsigned)result + 32;
+#else
+    return (unsigned)__builtin_ctzll(mask);
+#endif
+}
+
+/**
+ * Compares blocks of BLOCK_SIZE bytes.
+ *
+ * @return Mask with bit set for each byte that differs.
+ */
+static inline uint64_t block_diff(const uint8_t *left, const uint8_t *right) {
+#if defined(SNAPSHOT_AVX2)
+    const __m256i low = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)left), _mm256_loadu_si256((const __m256i*)right));
+    const __m256i high = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(left + 32)), _mm256_loadu_si256((const __m256i*)(right + 32)));
+
+    return ~((uint64_t)(uint32_t)_mm256_movemask_epi8(high) << 32 | (uint32_t)_mm256_movemask_epi8(low));
+#elif defined(SNAPSHOT_SSE2)
+    uint64_t equal = 0;
+
+    for (unsigned idx = 0; idx < BLOCK_SIZE / 16; idx++) {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(left + idx * 16)), _mm_loadu_si128((const __m128i*)(right + idx * 16)));
+
+        equal |= (uint64_t)(uint16_t)_mm_movemask_epi8(eq) << (idx * 16);
+    }
+
+    return ~equal;
+#else
+    uint64_t mask = 0;
+
+    for (unsigned idx = 0; idx < BLOCK_SIZE; idx += 8) {
+        uint64_t left_word, right_word;
+
+        memcpy(&left_word, left + idx, sizeof(left_word));
+        memcpy(&right_word, right + idx, sizeof(right_word));
+        if (left_word == right_word) continue;
+
+        for (unsigned byte = idx; byte < idx + 8; byte++) {
+            if (left[byte] != right[byte]) mask |= (uint64_t)1 << byte;
+        }
+    }
+
+    return mask;
+#endif
+}
+
+static bool page_is_zero(const uint8_t *page) {
+    for (size_t offset = 0; offset < PROCESS_SNAPSHOT_PAGE_SIZE; offset += BLOCK_SIZE) {
+        if (block_diff(page + offset, zero_page + offset) != 0) return false;
+    }
+
+    return true;
+}
+
+static inline uintptr_t region_end(const Process_snapshot_region *region) {
+    return (uintptr_t)(region->base + region->size);
+}
+
+static bool write_all(HANDLE file, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t*)data;
+
+    while (size > 0) {
+        const DWORD part = size < 0x40000000 ? (DWORD)size : 0x40000000;
+        DWORD written;
+
+        if (!WriteFile(file, bytes, part, &written, NULL) || written == 0) return false;
+
+        bytes += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+/**
+ * Reads chunk of pages and writes the ones that are not zero.
+ */
+static bool writer_add_chunk(snapshot_writer *writer, HANDLE process, uintptr_t base, size_t pages) {
+    uint8_t *buffer = writer->buffer;
+    uint32_t *entries = writer->pages + writer->pages_len;
+    const bool is_read = Process_read_mem(process, base, buffer, pages * PROCESS_SNAPSHOT_PAGE_SIZE) != NULL;
+    size_t stored = 0;
+
+    if (writer->data_pages + pages >= PROCESS_SNAPSHOT_PAGE_MISSING) return false;
+
+    for (size_t idx = 0; idx < pages; idx++) {
+        uint8_t *page = buffer + idx * PROCESS_SNAPSHOT_PAGE_SIZE;
+
+        /* Some pages of region can be guarded or decommitted meanwhile, so they are read one by one. */
+        if (!is_read && Process_read_mem(process, base + idx * PROCESS_SNAPSHOT_PAGE_SIZE, page, PROCESS_SNAPSHOT_PAGE_SIZE) == NULL) {
+            entries[idx] = PROCESS_SNAPSHOT_PAGE_MISSING;
+            continue;
+        }
+
+        if (page_is_zero(page)) {
+            entries[idx] = PROCESS_SNAPSHOT_PAGE_ZERO;
+            continue;
+        }
+
+        if (stored != idx) memcpy(buffer + stored * PROCESS_SNAPSHOT_PAGE_SIZE, page, PROCESS_SNAPSHOT_PAGE_SIZE);
+
+        stored++;
+        /* Header takes page 0, so numbers of data pages start with 1. */
+        entries[idx] = (uint32_t)(writer->data_pages + stored);
+    }
+
+    writer->pages_len += pages;
+    writer->data_pages += stored;
+    return write_all(writer->file, buffer, stored * PROCESS_SNAPSHOT_PAGE_SIZE);
+}
+
+static bool writer_add_region(snapshot_writer *writer, HANDLE process, const Process_region *region, uintptr_t base, uintptr_t end) {
+    const size_t pages = (size_t)(end - base) / PROCESS_SNAPSHOT_PAGE_SIZE;
+
+    if (writer->regions_len == writer->regions_capacity) {
+        const size_t capacity = writer->regions_capacity ? writer->regions_capacity * 2 : 64;
+        Process_snapshot_region *regions = (Process_snapshot_region*)realloc(writer->regions, capacity * sizeof(*regions));
+
+        if (regions == NULL) return false;
+        writer->regions = regions;
+        writer->regions_capacity = capacity;
+    }
+
+    if (writer->pages_capacity - writer->pages_len < pages) {
+        size_t capacity = writer->pages_capacity ? writer->pages_capacity * 2 : 1024;
+
+        while (capacity - writer->pages_len < pages) capacity *= 2;
+
+        uint32_t *entries = (uint32_t*)realloc(writer->pages, capacity * sizeof(*entries));
+
+        if (entries == NULL) return false;
+        writer->pages = entries;
+        writer->pages_capacity = capacity;
+    }
+
+    Process_snapshot_region *next = &writer->regions[writer->regions_len++];
+
+    next->base = base;
+    next->size = end - base;
+    next->protect = region->protect;
+    next->type = region->type;
+    next->first_page = writer->pages_len;
+
+    for (size_t page = 0; page < pages; page += PROCESS_SNAPSHOT_CHUNK_PAGES) {
+        const size_t chunk = pages - page < PROCESS_SNAPSHOT_CHUNK_PAGES ? pages - page : PROCESS_SNAPSHOT_CHUNK_PAGES;
+
+        if (!writer_add_chunk(writer, process, base + page * PROCESS_SNAPSHOT_PAGE_SIZE, chunk)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Writes tables after data and header at the start of file.
+ */
+static bool writer_finish(snapshot_writer *writer) {
+    snapshot_header header;
+    LARGE_INTEGER start;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.data_pages = writer->data_pages;
+    header.regions_offset = (writer->data_pages + 1) * PROCESS_SNAPSHOT_PAGE_SIZE;
+    header.regions_len = writer->regions_len;
+    header.pages_offset = header.regions_offset + writer->regions_len * sizeof(*writer->regions);
+    header.pages_len = writer->pages_len;
+    start.QuadPart = 0;
+
+    return write_all(writer->file, writer->regions, writer->regions_len * sizeof(*writer->regions)) &&
+           write_all(writer->file, writer->pages, writer->pages_len * sizeof(*writer->pages)) &&
+           SetFilePointerEx(writer->file, start, NULL, FILE_BEGIN) &&
+           write_all(writer->file, &header, sizeof(header));
+}
+
+bool Process_snapshot_take(HANDLE process, const wchar_t *path, const Process_snapshot_options *options) {
+    const Process_snapshot_options defaults = {0};
+    Process_region_iter iter;
+    Process_region region;
+
+    if (options == NULL) options = &defaults;
+
+    const uintptr_t start = options->start & ~PAGE_MASK;
+    const uintptr_t end = options->end && options->end <= UINTPTR_MAX - PAGE_MASK ? (options->end + PAGE_MASK) & ~PAGE_MASK : UINTPTR_MAX & ~PAGE_MASK;
+    snapshot_writer *writer = (snapshot_writer*)calloc(1, sizeof(*writer));
+
+    if (writer == NULL) return false;
+
+    writer->file = CreateFileW(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+    /* Place of header is reserved, and header itself is written when sizes are known. */
+    bool is_ok = writer->file != INVALID_HANDLE_VALUE && write_all(writer->file, writer->buffer, PROCESS_SNAPSHOT_PAGE_SIZE);
+
+    Process_region_iter_init(&iter, process, options->region_flags | PROCESS_REGION_READABLE | PROCESS_REGION_COALESCE);
+
+    while (is_ok && Process_region_iter_next(&iter, &region)) {
+        const uintptr_t base = region.base > start ? region.base : start;
+        const uintptr_t base_end = region.base + region.size < end ? region.base + region.size : end;
+
+        if (region.base + region.size <= start) continue;
+        if (region.base >= end) break;
+
+        is_ok = writer_add_region(writer, process, &region, base, base_end);
+    }
+
+    is_ok = is_ok && writer_finish(writer);
+
+    if (writer->file != INVALID_HANDLE_VALUE) {
+        (void)CloseHandle(writer->file);
+        if (!is_ok) (void)DeleteFileW(path);
+    }
+
+    free(writer->regions);
+    free(writer->pages);
+    free(writer);
+    return is_ok;
+}
+
+/**
+ * Checks that tables of mapped file are within it and regions are sorted.
+ */
+static bool snapshot_validate(Process_snapshot *snapshot, uint64_t size) {
+    snapshot_header header;
+    uint64_t previous_end = 0;
+
+    memcpy(&header, snapshot->view, sizeof(header));
+
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) return false;
+    if (header.data_pages >= PROCESS_SNAPSHOT_PAGE_MISSING || (header.data_pages + 1) * PROCESS_SNAPSHOT_PAGE_SIZE > size) return false;
+
+    if (header.regions_offset % sizeof(uint64_t) != 0 || header.regions_offset > size ||
+        header.regions_len > (size - header.regions_offset) / sizeof(Process_snapshot_region)) return false;
+
+    if (header.pages_offset % sizeof(uint32_t) != 0 || header.pages_offset > size ||
+        header.pages_len > (size - header.pages_offset) / sizeof(uint32_t)) return false;
+
+    snapshot->regions = (const Process_snapshot_region*)(snapshot->view + header.regions_offset);
+    snapshot->regions_len = (size_t)header.regions_len;
+    snapshot->pages = (const uint32_t*)(snapshot->view + header.pages_offset);
+    snapshot->pages_len = (size_t)header.pages_len;
+    snapshot->data_pages = (size_t)header.data_pages;
+
+    for (size_t idx = 0; idx < snapshot->regions_len; idx++) {
+        const Process_snapshot_region *region = &snapshot->regions[idx];
+
+        if (region->base % PROCESS_SNAPSHOT_PAGE_SIZE != 0 || region->size % PROCESS_SNAPSHOT_PAGE_SIZE != 0 || region->size == 0) return false;
+        if (region->base < previous_end || region->size > (uint64_t)UINTPTR_MAX - region->base) return false;
+        if (region->first_page > header.pages_len || region->size / PROCESS_SNAPSHOT_PAGE_SIZE > header.pages_len - region->first_page) return false;
+
+        previous_end = region->base + region->size;
+    }
+
+    return true;
+}
+
+bool Process_snapshot_open(Process_snapshot *snapshot, const wchar_t *path) {
+    LARGE_INTEGER size;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    snapshot->file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (snapshot->file == INVALID_HANDLE_VALUE) {
+        snapshot->file = NULL;
+        return false;
+    }
+
+    bool is_ok = GetFileSizeEx(snapshot->file, &size) &&
+                 (uint64_t)size.QuadPart >= PROCESS_SNAPSHOT_PAGE_SIZE && (uint64_t)size.QuadPart <= SIZE_MAX;
+
+    if (is_ok) {
+        snapshot->mapping = CreateFileMappingW(snapshot->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        is_ok = snapshot->mapping != NULL;
+    }
+
+    if (is_ok) {
+        snapshot->view = (const uint8_t*)MapViewOfFile(snapshot->mapping, FILE_MAP_READ, 0, 0, 0);
+        is_ok = snapshot->view != NULL && snapshot_validate(snapshot, (uint64_t)size.QuadPart);
+    }
+
+    if (!is_ok) Process_snapshot_close(snapshot);
+    return is_ok;
+}
+
+void Process_snapshot_close(Process_snapshot *snapshot) {
+    if (snapshot->view != NULL) (void)UnmapViewOfFile(snapshot->view);
+    if (snapshot->mapping != NULL) (void)CloseHandle(snapshot->mapping);
+    if (snapshot->file != NULL) (void)CloseHandle(snapshot->file);
+
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+/**
+ * @return Index of the first region that ends after address.
+ */
+static size_t snapshot_find_region(const Process_snapshot *snapshot, uintptr_t address) {
+    size_t low = 0;
+    size_t high = snapshot->regions_len;
+
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+
+        if (region_end(&snapshot->regions[middle]) <= address) low = middle + 1;
+        else high = middle;
+    }
+
+    return low;
+}
+
+/**
+ * @return Captured data of page at address of region or NULL if page cannot be read.
+ */
+static const uint8_t* snapshot_page(const Process_snapshot *snapshot, const Process_snapshot_region *region, uintptr_t address) {
+    const uint32_t entry = snapshot->pages[(size_t)region->first_page + (address - (uintptr_t)region->base) / PROCESS_SNAPSHOT_PAGE_SIZE];
+
+    if (entry == PROCESS_SNAPSHOT_PAGE_ZERO) return zero_page;
+    if (entry > snapshot->data_pages) return NULL;
+    return snapshot->view + (size_t)entry * PROCESS_SNAPSHOT_PAGE_SIZE;
+}
+
+bool Process_snapshot_read(const Process_snapshot *snapshot, uintptr_t base, uint8_t *buffer, size_t size) {
+    size_t idx = snapshot_find_region(snapshot, base);
+
+    while (size > 0) {
+        if (idx == snapshot->regions_len || snapshot->regions[idx].base > base) return false;
+
+        const Process_snapshot_region *region = &snapshot->regions[idx];
+        const uint8_t *page = snapshot_page(snapshot, region, base & ~PAGE_MASK);
+        const size_t offset = (size_t)(base & PAGE_MASK);
+        const size_t part = size < PROCESS_SNAPSHOT_PAGE_SIZE - offset ? size : PROCESS_SNAPSHOT_PAGE_SIZE - offset;
+
+        if (page == NULL) return false;
+
+        memcpy(buffer, page + offset, part);
+        buffer += part;
+        base += part;
+        size -= part;
+
+        if (base == region_end(region)) idx++;
+    }
+
+    return true;
+}
+
+/**
+ * Adds changed range, merging it with the last one if they are adjacent.
+ */
+static void diff_add(snapshot_diff *diff, uintptr_t base, size_t size) {
+    if (diff->count > 0 && diff->end == base) {
+        if (diff->count <= diff->len) diff->ranges[diff->count - 1].size += size;
+    }
+    else {
+        if (diff->count < diff->len) {
+            diff->ranges[diff->count].base = base;
+            diff->ranges[diff->count].size = size;
+        }
+
+        diff->count++;
+    }
+
+    diff->end = base + size;
+}
+
+static void diff_page(snapshot_diff *diff, uintptr_t base, const uint8_t *before, const uint8_t *after) {
+    if (before == after) return;
+
+    for (size_t offset = 0; offset < PROCESS_SNAPSHOT_PAGE_SIZE; offset += BLOCK_SIZE) {
+        uint64_t mask = block_diff(before + offset, after + offset);
+
+        /* Each run of set bits is range of changed bytes. */
+        while (mask != 0) {
+            const unsigned first = first_bit64(mask);
+            const uint64_t rest = ~(mask >> first);
+            const unsigned run = rest == 0 ? 64 - first : first_bit64(rest);
+
+            diff_add(diff, base + offset + first, run);
+            mask = first + run == 64 ? 0 : mask & (UINT64_MAX << (first + run));
+        }
+    }
+}
+
+size_t Process_snapshot_diff(const Process_snapshot *before, const Process_snapshot *after, Process_snapshot_range *ranges, size_t len) {
+    snapshot_diff diff = {ranges, len, 0, 0};
+    size_t before_idx = 0;
+    size_t after_idx = 0;
+    uintptr_t address = 0;
+
+    for (;;) {
+        while (before_idx < before->regions_len && region_end(&before->regions[before_idx]) <= address) before_idx++;
+        while (after_idx < after->regions_len && region_end(&after->regions[after_idx]) <= address) after_idx++;
+
+        const Process_snapshot_region *before_region = before_idx < before->regions_len ? &before->regions[before_idx] : NULL;
+        const Process_snapshot_region *after_region = after_idx < after->regions_len ? &after->regions[after_idx] : NULL;
+
+        if (before_region == NULL && after_region == NULL) break;
+
+        /* Skip to the next page captured by either of snapshots. */
+        uintptr_t next = UINTPTR_MAX;
+
+        if (before_region != NULL && (uintptr_t)before_region->base < next) next = (uintptr_t)before_region->base;
+        if (after_region != NULL && (uintptr_t)after_region->base < next) next = (uintptr_t)after_region->base;
+        if (next > address) address = next;
+
+        const uint8_t *before_page = before_region != NULL && before_region->base <= address ? snapshot_page(before, before_region, address) : NULL;
+        const uint8_t *after_page = after_region != NULL && after_region->base <= address ? snapshot_page(after, after_region, address) : NULL;
+
+        if (before_page != NULL && after_page != NULL) diff_page(&diff, address, before_page, after_page);
+        else if (before_page != NULL || after_page != NULL) diff_add(&diff, address, PROCESS_SNAPSHOT_PAGE_SIZE);
+
+        address += PROCESS_SNAPSHOT_PAGE_SIZE;
+    }
+
+    return diff.count;
+}
+
+size_t Process_snapshot_diff_live(const Process_snapshot *snapshot, HANDLE process, Process_snapshot_range *ranges, size_t len) {
+    snapshot_diff diff = {ranges, len, 0, 0};
+    uint8_t *buffer = (uint8_t*)malloc(PROCESS_SNAPSHOT_CHUNK_PAGES * PROCESS_SNAPSHOT_PAGE_SIZE);
+
+    if (buffer == NULL) return 0;
+
+    for (size_t idx = 0; idx < snapshot->regions_len; idx++) {
+        const Process_snapshot_region *region = &snapshot->regions[idx];
+        const uintptr_t end = region_end(region);
+
+        for (uintptr_t chunk = (uintptr_t)region->base; chunk < end; chunk += PROCESS_SNAPSHOT_CHUNK_PAGES * PROCESS_SNAPSHOT_PAGE_SIZE) {
+            const size_t rest = (size_t)(end - chunk) / PROCESS_SNAPSHOT_PAGE_SIZE;
+            const size_t pages = rest < PROCESS_SNAPSHOT_CHUNK_PAGES ? rest : PROCESS_SNAPSHOT_CHUNK_PAGES;
+            const bool is_read = Process_read_mem(process, chunk, buffer, pages * PROCESS_SNAPSHOT_PAGE_SIZE) != NULL;
+
+            for (size_t page = 0; page < pages; page++) {
+                const uintptr_t address = chunk + page * PROCESS_SNAPSHOT_PAGE_SIZE;
+                const uint8_t *captured = snapshot_page(snapshot, region, address);
+                const uint8_t *live = buffer + page * PROCESS_SNAPSHOT_PAGE_SIZE;
+
+                if (!is_read && Process_read_mem(process, address, buffer + page * PROCESS_SNAPSHOT_PAGE_SIZE, PROCESS_SNAPSHOT_PAGE_SIZE) == NULL) live = NULL;
+
+                if (captured != NULL && live != NULL) diff_page(&diff, address, captured, live);
+                else if (captured != NULL || live != NULL) diff_add(&diff, address, PROCESS_SNAPSHOT_PAGE_SIZE);
+            }
+        }
+    }
+
+    free(buffer);
+    return diff.count;
+}
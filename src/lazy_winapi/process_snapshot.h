@@ -0,0 +1,226 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref ProcessSnapshot module.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <windows.h>
+
+#include "process.h"
+
+/**
+ * @addtogroup ProcessSnapshot
+ *
+ * Snapshots of process memory in memory-mapped files and diffs between them.
+ *
+ * Requires @ref Process module.
+ *
+ * Snapshot is streamed into file chunk by chunk, so memory of target doesn't have to fit into memory of caller.
+ * Pages that hold only zeros are not stored.
+ * Opened snapshot is mapped into memory, and its pages are read from the file only when compared.
+ *
+ * Diff compares pages by blocks of 64 bytes with AVX2 or SSE2 when compiler targets them,
+ * and reports byte exact ranges that changed.
+ *
+ * File layout
+ * ---------
+ *
+ * - Header that takes whole page;
+ * - Data of stored pages, each at offset that is its number multiplied by PROCESS_SNAPSHOT_PAGE_SIZE;
+ * - Array of Process_snapshot_region;
+ * - Array of `uint32_t` with number of data page for each page of regions,
+ *   PROCESS_SNAPSHOT_PAGE_ZERO for zero page or PROCESS_SNAPSHOT_PAGE_MISSING for page that cannot be read.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Find what changes between two states
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "process_snapshot.h"
+
+    Process_snapshot before;
+    Process_snapshot_range ranges[64];
+
+    Process_snapshot_take(process, L"before.snapshot", NULL);
+    Process_snapshot_open(&before, L"before.snapshot");
+
+    // Change state of process
+
+    const size_t count = Process_snapshot_diff_live(&before, process, ranges, 64);
+
+    for (size_t idx = 0; idx < count && idx < 64; idx++) {
+        printf("Changed %zu bytes at address=%p\n", ranges[idx].size, (void*)ranges[idx].base);
+    }
+
+    Process_snapshot_close(&before);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Size of page in snapshot.
+ */
+#define PROCESS_SNAPSHOT_PAGE_SIZE 4096
+
+/**
+ * Number of pages that are read and written at once while taking snapshot.
+ */
+#define PROCESS_SNAPSHOT_CHUNK_PAGES 64
+
+/**
+ * Page table entry of page with only zeros.
+ */
+#define PROCESS_SNAPSHOT_PAGE_ZERO 0
+
+/**
+ * Page table entry of page that cannot be read.
+ */
+#define PROCESS_SNAPSHOT_PAGE_MISSING UINT32_MAX
+
+/**
+ * Options of snapshot. Zero initialized options capture every readable region.
+ *
+ * Range of addresses is extended to whole pages.
+ */
+typedef struct {
+    /** Start of range of addresses to capture. */
+    uintptr_t start;
+    /** End of range of addresses to capture. 0 means end of address space. */
+    uintptr_t end;
+    /** Filters of regions as `PROCESS_REGION_*` flags. Readable regions are always required. */
+    unsigned region_flags;
+} Process_snapshot_options;
+
+/**
+ * Captured region as it is stored in file.
+ */
+typedef struct {
+    /** Address of region. */
+    uint64_t base;
+    /** Size of region. Multiple of PROCESS_SNAPSHOT_PAGE_SIZE. */
+    uint64_t size;
+    /** Protection of pages. */
+    uint32_t protect;
+    /** Type of pages: `MEM_IMAGE`, `MEM_MAPPED` or `MEM_PRIVATE`. */
+    uint32_t type;
+    /** Index of the first page of region in page table. */
+    uint64_t first_page;
+} Process_snapshot_region;
+
+/**
+ * Opened snapshot.
+ *
+ * Regions can be read, other fields are private.
+ */
+typedef struct {
+    HANDLE file;
+    HANDLE mapping;
+    const uint8_t *view;
+
+    /** Regions in order of addresses. */
+    const Process_snapshot_region *regions;
+    /** Number of regions. */
+    size_t regions_len;
+
+    /** Page table. */
+    const uint32_t *pages;
+    size_t pages_len;
+    /** Number of stored pages. */
+    size_t data_pages;
+} Process_snapshot;
+
+/**
+ * Range of changed bytes.
+ */
+typedef struct {
+    /** Address of range. */
+    uintptr_t base;
+    /** Number of bytes. */
+    size_t size;
+} Process_snapshot_range;
+
+/**
+ * Captures memory of process into file.
+ *
+ * File is overwritten if it exists, and removed on failure.
+ *
+ * @note Requires access rights PROCESS_VM_READ and PROCESS_QUERY_INFORMATION or PROCESS_QUERY_LIMITED_INFORMATION.
+ *
+ * @param[in] process Handle to the process.
+ * @param[in] path Path to the file.
+ * @param[in] options Options. If NULL, defaults are used.
+ *
+ * @retval true On success.
+ * @retval false If file cannot be written or memory cannot be allocated.
+ */
+bool Process_snapshot_take(HANDLE process, const wchar_t *path, const Process_snapshot_options *options);
+
+/**
+ * Opens snapshot file and maps it into memory.
+ *
+ * @param[out] snapshot Snapshot.
+ * @param[in] path Path to the file.
+ *
+ * @retval true On success.
+ * @retval false If file cannot be mapped or is not valid snapshot.
+ */
+bool Process_snapshot_open(Process_snapshot *snapshot, const wchar_t *path);
+
+/**
+ * Closes snapshot.
+ *
+ * @param[in,out] snapshot Snapshot.
+ */
+void Process_snapshot_close(Process_snapshot *snapshot);
+
+/**
+ * Reads captured memory.
+ *
+ * @param[in] snapshot Snapshot.
+ * @param[in] base Address of memory.
+ * @param[out] buffer Memory to hold data.
+ * @param[in] size Number of bytes to read.
+ *
+ * @retval true On success.
+ * @retval false If any byte of range is not captured.
+ */
+bool Process_snapshot_read(const Process_snapshot *snapshot, uintptr_t base, uint8_t *buffer, size_t size);
+
+/**
+ * Finds changes between two snapshots.
+ *
+ * Page that is captured by only one of snapshots is changed as whole.
+ * Pages captured by neither are skipped.
+ *
+ * @param[in] before Older snapshot.
+ * @param[in] after Newer snapshot.
+ * @param[out] ranges Memory to hold the lowest changed ranges in ascending order. Adjacent ranges are merged.
+ * @param[in] len Number of elements in ranges.
+ *
+ * @return Number of changed ranges, which can be bigger than len.
+ */
+size_t Process_snapshot_diff(const Process_snapshot *before, const Process_snapshot *after, Process_snapshot_range *ranges, size_t len);
+
+/**
+ * Finds changes between snapshot and current memory of process.
+ *
+ * Only captured pages are compared. Captured page that cannot be read anymore is changed as whole.
+ *
+ * @note Requires access right PROCESS_VM_READ.
+ *
+ * @param[in] snapshot Snapshot.
+ * @param[in] process Handle to the process.
+ * @param[out] ranges Memory to hold the lowest changed ranges in ascending order. Adjacent ranges are merged.
+ * @param[in] len Number of elements in ranges.
+ *
+ * @return Number of changed ranges, which can be bigger than len.
+ * @retval 0 If there are no changes or memory for diff cannot be allocated.
+ */
+size_t Process_snapshot_diff_live(const Process_snapshot *snapshot, HANDLE process, Process_snapshot_range *ranges, size_t len);
+
+/*@}*/
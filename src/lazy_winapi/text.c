@@ -0,0 +1,550 @@
+/**
+ * @file
+ *
+ * Source code of @ref Text module.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "text.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#   define TEXT_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define TEXT_SSE2
+#endif
+
+/** Replacement of invalid input. */
+#define REPLACEMENT_CHAR 0xFFFD
+/** Carriage return. */
+#define CHAR_CR 0x0D
+/** Line feed. */
+#define CHAR_LF 0x0A
+
+#if defined(TEXT_SSE2)
+/**
+ * @return Index of the lowest set bit in non-zero mask.
+ */
+static inline unsigned first_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long result;
+    (void)_BitScanForward(&result, mask);
+    return (unsigned)result;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+#if defined(TEXT_AVX2)
+/**
+ * @return Whether 32 UTF-16 code units are all ASCII.
+ */
+static inline bool avx2_is_ascii_utf16(__m256i left, __m256i right) {
+    const __m256i non_ascii = _mm256_and_si256(_mm256_or_si256(left, right), _mm256_set1_epi16((short)0xFF80));
+
+    return _mm256_testz_si256(non_ascii, non_ascii) != 0;
+}
+#endif
+
+#if defined(TEXT_SSE2)
+/**
+ * @return Whether 16 UTF-16 code units are all ASCII.
+ */
+static inline bool sse2_is_ascii_utf16(__m128i left, __m128i right) {
+    const __m128i non_ascii = _mm_and_si128(_mm_or_si128(left, right), _mm_set1_epi16((short)0xFF80));
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) == 0xFFFF;
+}
+#endif
+
+/**
+ * Converts leading ASCII of UTF-8 into UTF-16.
+ *
+ * @param[in] src UTF-8 text.
+ * @param[in] len Maximum number of bytes to convert.
+ * @param[out] dst Memory for at least len code units. If NULL, ASCII is only counted.
+ *
+ * @return Number of converted bytes.
+ */
+static size_t ascii_to_utf16(const uint8_t *src, size_t len, uint16_t *dst) {
+    size_t idx = 0;
+
+#if defined(TEXT_AVX2)
+    for (; idx + 32 <= len; idx += 32) {
+        const __m256i bytes = _mm256_loadu_si256((const __m256i*)(src + idx));
+
+        if (_mm256_movemask_epi8(bytes) != 0) break;
+
+        if (dst) {
+            _mm256_storeu_si256((__m256i*)(dst + idx), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+            _mm256_storeu_si256((__m256i*)(dst + idx + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+        }
+    }
+#endif
+
+#if defined(TEXT_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; idx + 16 <= len; idx += 16) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(src + idx));
+
+        if (_mm_movemask_epi8(bytes) != 0) break;
+
+        if (dst) {
+            _mm_storeu_si128((__m128i*)(dst + idx), _mm_unpacklo_epi8(bytes, zero));
+            _mm_storeu_si128((__m128i*)(dst + idx + 8), _mm_unpackhi_epi8(bytes, zero));
+        }
+    }
+#endif
+
+    for (; idx < len && src[idx] < 0x80; idx++) {
+        if (dst) dst[idx] = src[idx];
+    }
+
+    return idx;
+}
+
+/**
+ * Converts leading ASCII of UTF-16 into UTF-8.
+ *
+ * @param[in] src UTF-16 text.
+ * @param[in] len Maximum number of code units to convert.
+ * @param[out] dst Memory for at least len bytes. If NULL, ASCII is only counted.
+ *
+ * @return Number of converted code units.
+ */
+static size_t ascii_to_utf8(const uint16_t *src, size_t len, uint8_t *dst) {
+    size_t idx = 0;
+
+#if defined(TEXT_AVX2)
+    for (; idx + 32 <= len; idx += 32) {
+        const __m256i left = _mm256_loadu_si256((const __m256i*)(src + idx));
+        const __m256i right = _mm256_loadu_si256((const __m256i*)(src + idx + 16));
+
+        if (!avx2_is_ascii_utf16(left, right)) break;
+
+        if (dst) {
+            /* Packing works within 128-bit lanes, so restore order of quadwords. */
+            const __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(left, right), 0xD8);
+            _mm256_storeu_si256((__m256i*)(dst + idx), bytes);
+        }
+    }
+#endif
+
+#if defined(TEXT_SSE2)
+    for (; idx + 16 <= len; idx += 16) {
+        const __m128i left = _mm_loadu_si128((const __m128i*)(src + idx));
+        const __m128i right = _mm_loadu_si128((const __m128i*)(src + idx + 8));
+
+        if (!sse2_is_ascii_utf16(left, right)) break;
+
+        if (dst) _mm_storeu_si128((__m128i*)(dst + idx), _mm_packus_epi16(left, right));
+    }
+#endif
+
+    for (; idx < len && src[idx] < 0x80; idx++) {
+        if (dst) dst[idx] = (uint8_t)src[idx];
+    }
+
+    return idx;
+}
+
+/**
+ * Decodes single UTF-8 sequence.
+ *
+ * Invalid sequence is decoded as REPLACEMENT_CHAR and its maximal valid part is consumed.
+ *
+ * @param[in] src UTF-8 text. At least one byte.
+ * @param[in] len Number of bytes in src.
+ * @param[out] code_point Decoded code point.
+ *
+ * @return Number of consumed bytes.
+ */
+static size_t utf8_decode(const uint8_t *src, size_t len, uint32_t *code_point) {
+    const uint8_t lead = src[0];
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    uint32_t value = 0;
+    size_t seq_len = 0;
+
+    if (lead < 0x80) {
+        *code_point = lead;
+        return 1;
+    }
+    else if (lead >= 0xC2 && lead <= 0xDF) {
+        seq_len = 2;
+        value = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        seq_len = 3;
+        value = lead & 0x0F;
+        /* Reject overlong forms and surrogates. */
+        if (lead == 0xE0) low = 0xA0;
+        else if (lead == 0xED) high = 0x9F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        seq_len = 4;
+        value = lead & 0x07;
+        /* Reject overlong forms and code points above U+10FFFF. */
+        if (lead == 0xF0) low = 0x90;
+        else if (lead == 0xF4) high = 0x8F;
+    }
+    else {
+        *code_point = REPLACEMENT_CHAR;
+        return 1;
+    }
+
+    for (size_t idx = 1; idx < seq_len; idx++) {
+        if (idx >= len || src[idx] < low || src[idx] > high) {
+            *code_point = REPLACEMENT_CHAR;
+            return idx;
+        }
+
+        value = (value << 6) | (src[idx] & 0x3F);
+        low = 0x80;
+        high = 0xBF;
+    }
+
+    *code_point = value;
+    return seq_len;
+}
+
+/**
+ * Encodes code point as UTF-8.
+ *
+ * @param[in] code_point Valid code point.
+ * @param[out] dst Memory to hold result.
+ * @param[in] len Number of bytes to encode code point.
+ */
+static void utf8_encode(uint32_t code_point, uint8_t *dst, size_t len) {
+    switch (len) {
+        case 1:
+            dst[0] = (uint8_t)code_point;
+            break;
+        case 2:
+            dst[0] = (uint8_t)(0xC0 | (code_point >> 6));
+            dst[1] = (uint8_t)(0x80 | (code_point & 0x3F));
+            break;
+        case 3:
+            dst[0] = (uint8_t)(0xE0 | (code_point >> 12));
+            dst[1] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+            dst[2] = (uint8_t)(0x80 | (code_point & 0x3F));
+            break;
+        default:
+            dst[0] = (uint8_t)(0xF0 | (code_point >> 18));
+            dst[1] = (uint8_t)(0x80 | ((code_point >> 12) & 0x3F));
+            dst[2] = (uint8_t)(0x80 | ((code_point >> 6) & 0x3F));
+            dst[3] = (uint8_t)(0x80 | (code_point & 0x3F));
+            break;
+    }
+}
+
+size_t Text_utf8_to_utf16(const char *src, size_t src_len, uint16_t *dst, size_t dst_len) {
+    const uint8_t *bytes = (const uint8_t*)src;
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        size_t ascii_len = src_len - src_idx;
+
+        if (dst && dst_len - dst_idx < ascii_len) ascii_len = dst_len - dst_idx;
+
+        const size_t ascii = ascii_to_utf16(bytes + src_idx, ascii_len, dst ? dst + dst_idx : NULL);
+
+        src_idx += ascii;
+        dst_idx += ascii;
+        if (src_idx >= src_len) break;
+
+        uint32_t code_point = 0;
+        const size_t seq_len = utf8_decode(bytes + src_idx, src_len - src_idx, &code_point);
+        const size_t units = code_point >= 0x10000 ? 2 : 1;
+
+        if (dst) {
+            if (dst_len - dst_idx < units) break;
+
+            if (units == 2) {
+                dst[dst_idx] = (uint16_t)(0xD800 + ((code_point - 0x10000) >> 10));
+                dst[dst_idx + 1] = (uint16_t)(0xDC00 + ((code_point - 0x10000) & 0x3FF));
+            }
+            else {
+                dst[dst_idx] = (uint16_t)code_point;
+            }
+        }
+
+        src_idx += seq_len;
+        dst_idx += units;
+    }
+
+    return dst_idx;
+}
+
+size_t Text_utf16_to_utf8(const uint16_t *src, size_t src_len, char *dst, size_t dst_len) {
+    uint8_t *bytes = (uint8_t*)dst;
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        size_t ascii_len = src_len - src_idx;
+
+        if (bytes && dst_len - dst_idx < ascii_len) ascii_len = dst_len - dst_idx;
+
+        const size_t ascii = ascii_to_utf8(src + src_idx, ascii_len, bytes ? bytes + dst_idx : NULL);
+
+        src_idx += ascii;
+        dst_idx += ascii;
+        if (src_idx >= src_len) break;
+
+        uint32_t code_point = src[src_idx];
+        size_t units = 1;
+
+        if (code_point >= 0xD800 && code_point <= 0xDBFF &&
+            src_idx + 1 < src_len && src[src_idx + 1] >= 0xDC00 && src[src_idx + 1] <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (src[src_idx + 1] - 0xDC00u);
+            units = 2;
+        }
+        else if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+            /* Unpaired surrogate. */
+            code_point = REPLACEMENT_CHAR;
+        }
+
+        const size_t len = code_point < 0x80 ? 1 : code_point < 0x800 ? 2 : code_point < 0x10000 ? 3 : 4;
+
+        if (bytes) {
+            if (dst_len - dst_idx < len) break;
+
+            utf8_encode(code_point, bytes + dst_idx, len);
+        }
+
+        src_idx += units;
+        dst_idx += len;
+    }
+
+    return dst_idx;
+}
+
+/**
+ * Finds byte.
+ *
+ * @return Index of the first occurrence of value or len if there is none.
+ */
+static size_t find_u8(const uint8_t *src, size_t len, uint8_t value) {
+    size_t idx = 0;
+
+#if defined(TEXT_AVX2)
+    const __m256i needle256 = _mm256_set1_epi8((char)value);
+
+    for (; idx + 32 <= len; idx += 32) {
+        const __m256i bytes = _mm256_loadu_si256((const __m256i*)(src + idx));
+        const uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, needle256));
+
+        if (mask != 0) return idx + first_bit(mask);
+    }
+#endif
+
+#if defined(TEXT_SSE2)
+    const __m128i needle = _mm_set1_epi8((char)value);
+
+    for (; idx + 16 <= len; idx += 16) {
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(src + idx));
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, needle));
+
+        if (mask != 0) return idx + first_bit(mask);
+    }
+#endif
+
+    for (; idx < len && src[idx] != value; idx++);
+
+    return idx;
+}
+
+/**
+ * Finds code unit.
+ *
+ * @return Index of the first occurrence of value or len if there is none.
+ */
+static size_t find_u16(const uint16_t *src, size_t len, uint16_t value) {
+    size_t idx = 0;
+
+#if defined(TEXT_AVX2)
+    const __m256i needle256 = _mm256_set1_epi16((short)value);
+
+    for (; idx + 16 <= len; idx += 16) {
+        const __m256i units = _mm256_loadu_si256((const __m256i*)(src + idx));
+        const uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(units, needle256));
+
+        /* Each code unit sets two bits of mask. */
+        if (mask != 0) return idx + first_bit(mask) / 2;
+    }
+#endif
+
+#if defined(TEXT_SSE2)
+    const __m128i needle = _mm_set1_epi16((short)value);
+
+    for (; idx + 8 <= len; idx += 8) {
+        const __m128i units = _mm_loadu_si128((const __m128i*)(src + idx));
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(units, needle));
+
+        if (mask != 0) return idx + first_bit(mask) / 2;
+    }
+#endif
+
+    for (; idx < len && src[idx] != value; idx++);
+
+    return idx;
+}
+
+size_t Text_lf_to_crlf(const char *src, size_t src_len, char *dst, size_t dst_len) {
+    const uint8_t *bytes = (const uint8_t*)src;
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        const size_t run = find_u8(bytes + src_idx, src_len - src_idx, CHAR_LF);
+
+        if (dst) {
+            if (dst_len - dst_idx < run) {
+                memcpy(dst + dst_idx, src + src_idx, dst_len - dst_idx);
+                return dst_len;
+            }
+
+            memcpy(dst + dst_idx, src + src_idx, run);
+        }
+
+        src_idx += run;
+        dst_idx += run;
+        if (src_idx >= src_len) break;
+
+        const bool bare = src_idx == 0 || bytes[src_idx - 1] != CHAR_CR;
+        const size_t len = bare ? 2 : 1;
+
+        if (dst) {
+            if (dst_len - dst_idx < len) break;
+
+            if (bare) dst[dst_idx] = CHAR_CR;
+            dst[dst_idx + len - 1] = CHAR_LF;
+        }
+
+        src_idx++;
+        dst_idx += len;
+    }
+
+    return dst_idx;
+}
+
+size_t Text_crlf_to_lf(const char *src, size_t src_len, char *dst, size_t dst_len) {
+    const uint8_t *bytes = (const uint8_t*)src;
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        const size_t run = find_u8(bytes + src_idx, src_len - src_idx, CHAR_CR);
+
+        if (dst) {
+            if (dst_len - dst_idx < run) {
+                memcpy(dst + dst_idx, src + src_idx, dst_len - dst_idx);
+                return dst_len;
+            }
+
+            memcpy(dst + dst_idx, src + src_idx, run);
+        }
+
+        src_idx += run;
+        dst_idx += run;
+        if (src_idx >= src_len) break;
+
+        src_idx++;
+        /* CR of CRLF is dropped, and LF goes with the next run. */
+        if (src_idx < src_len && bytes[src_idx] == CHAR_LF) continue;
+
+        if (dst) {
+            if (dst_idx >= dst_len) break;
+
+            dst[dst_idx] = CHAR_CR;
+        }
+        dst_idx++;
+    }
+
+    return dst_idx;
+}
+
+size_t Text_lf_to_crlf_utf16(const uint16_t *src, size_t src_len, uint16_t *dst, size_t dst_len) {
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        const size_t run = find_u16(src + src_idx, src_len - src_idx, CHAR_LF);
+
+        if (dst) {
+            if (dst_len - dst_idx < run) {
+                memcpy(dst + dst_idx, src + src_idx, (dst_len - dst_idx) * sizeof(*dst));
+                return dst_len;
+            }
+
+            memcpy(dst + dst_idx, src + src_idx, run * sizeof(*dst));
+        }
+
+        src_idx += run;
+        dst_idx += run;
+        if (src_idx >= src_len) break;
+
+        const bool bare = src_idx == 0 || src[src_idx - 1] != CHAR_CR;
+        const size_t len = bare ? 2 : 1;
+
+        if (dst) {
+            if (dst_len - dst_idx < len) break;
+
+            if (bare) dst[dst_idx] = CHAR_CR;
+            dst[dst_idx + len - 1] = CHAR_LF;
+        }
+
+        src_idx++;
+        dst_idx += len;
+    }
+
+    return dst_idx;
+}
+
+size_t Text_crlf_to_lf_utf16(const uint16_t *src, size_t src_len, uint16_t *dst, size_t dst_len) {
+    size_t src_idx = 0;
+    size_t dst_idx = 0;
+
+    while (src_idx < src_len) {
+        const size_t run = find_u16(src + src_idx, src_len - src_idx, CHAR_CR);
+
+        if (dst) {
+            if (dst_len - dst_idx < run) {
+                memcpy(dst + dst_idx, src + src_idx, (dst_len - dst_idx) * sizeof(*dst));
+                return dst_len;
+            }
+
+            memcpy(dst + dst_idx, src + src_idx, run * sizeof(*dst));
+        }
+
+        src_idx += run;
+        dst_idx += run;
+        if (src_idx >= src_len) break;
+
+        src_idx++;
+        /* CR of CRLF is dropped, and LF goes with the next run. */
+        if (src_idx < src_len && src[src_idx] == CHAR_LF) continue;
+
+        if (dst) {
+            if (dst_idx >= dst_len) break;
+
+            dst[dst_idx] = CHAR_CR;
+        }
+        dst_idx++;
+    }
+
+    return dst_idx;
+}
@@ -0,0 +1,129 @@
+#pragma once
+/**
+ * @file
+ *
+ * Header of @ref Text module.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup Text
+ *
+ * Portable text conversion kernels.
+ *
+ * Module does not depend on WinAPI.
+ * Runs of ASCII are processed with SSE2 or AVX2 when compiler targets them,
+ * and the rest falls back to scalar code.
+ *
+ * Invalid input is replaced with U+FFFD.
+ *
+ * Line endings are converted with vectorized search of CR and LF,
+ * copying text between them in bulk.
+ *
+ * Examples
+ * ---------
+ *
+ * ### Convert UTF-8 into UTF-16
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "text.h"
+
+    const char text[] = "For my waifu!";
+    const size_t len = Text_utf8_to_utf16(text, sizeof(text) - 1, NULL, 0);
+    uint16_t *wide_text = malloc(len * sizeof(*wide_text));
+
+    Text_utf8_to_utf16(text, sizeof(text) - 1, wide_text, len);
+ * ~~~~~~~~~~~~~~~
+ *
+ * ### Convert line endings into CRLF
+ *
+ * ~~~~~~~~~~~~~~~{.c}
+    #include "text.h"
+
+    const char text[] = "For\nmy\nwaifu!";
+    const size_t len = Text_lf_to_crlf(text, sizeof(text) - 1, NULL, 0);
+    char *crlf_text = malloc(len);
+
+    Text_lf_to_crlf(text, sizeof(text) - 1, crlf_text, len);
+ * ~~~~~~~~~~~~~~~
+ */
+/*@{*/
+
+/**
+ * Converts UTF-8 into UTF-16.
+ *
+ * Conversion stops at the first code point that does not fit into destination.
+ *
+ * @param[in] src UTF-8 text.
+ * @param[in] src_len Number of bytes in src.
+ * @param[out] dst Memory to hold UTF-16 text. If NULL, only required length is calculated.
+ * @param[in] dst_len Number of code units in dst.
+ *
+ * @return Number of written code units.
+ *         If dst is NULL, number of code units required to convert whole src.
+ */
+size_t Text_utf8_to_utf16(const char *src, size_t src_len, uint16_t *dst, size_t dst_len);
+
+/**
+ * Converts UTF-16 into UTF-8.
+ *
+ * Conversion stops at the first code point that does not fit into destination.
+ *
+ * @param[in] src UTF-16 text.
+ * @param[in] src_len Number of code units in src.
+ * @param[out] dst Memory to hold UTF-8 text. If NULL, only required length is calculated.
+ * @param[in] dst_len Number of bytes in dst.
+ *
+ * @return Number of written bytes.
+ *         If dst is NULL, number of bytes required to convert whole src.
+ */
+size_t Text_utf16_to_utf8(const uint16_t *src, size_t src_len, char *dst, size_t dst_len);
+
+/**
+ * Converts bare LF into CRLF.
+ *
+ * LF that is already preceded by CR is kept as it is.
+ * Conversion stops at the first line ending that does not fit into destination.
+ *
+ * @param[in] src Text.
+ * @param[in] src_len Number of bytes in src.
+ * @param[out] dst Memory to hold converted text. If NULL, only required length is calculated.
+ * @param[in] dst_len Number of bytes in dst.
+ *
+ * @return Number of written bytes.
+ *         If dst is NULL, number of bytes required to convert whole src.
+ */
+size_t Text_lf_to_crlf(const char *src, size_t src_len, char *dst, size_t dst_len);
+
+/**
+ * Converts CRLF into LF.
+ *
+ * Bare CR is kept as it is.
+ *
+ * @param[in] src Text.
+ * @param[in] src_len Number of bytes in src.
+ * @param[out] dst Memory to hold converted text. If NULL, only required length is calculated.
+ * @param[in] dst_len Number of bytes in dst.
+ *
+ * @return Number of written bytes.
+ *         If dst is NULL, number of bytes required to convert whole src.
+ */
+size_t Text_crlf_to_lf(const char *src, size_t src_len, char *dst, size_t dst_len);
+
+/**
+ * UTF-16 variant of Text_lf_to_crlf().
+ *
+ * Lengths are in code units.
+ */
+size_t Text_lf_to_crlf_utf16(const uint16_t *src, size_t src_len, uint16_t *dst, size_t dst_len);
+
+/**
+ * UTF-16 variant of Text_crlf_to_lf().
+ *
+ * Lengths are in code units.
+ */
+size_t Text_crlf_to_lf_utf16(const uint16_t *src, size_t src_len, uint16_t *dst, size_t dst_len);
+
+/*@}*/
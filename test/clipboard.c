@@ -56,6 +56,113 @@ Test(clipboard, set_clipboard_wide_text) {
     cr_assert_wcs_eq(extract_text, text);
 }
 
+/**
+ * Test setting of clipboard with multiple formats at once.
+ */
+Test(clipboard, set_clipboard_many) {
+    const char text[] = "For my waifu!";
+    const wchar_t wide_text[] = L"For my waifu!";
+    const uint8_t data[] = {1, 2, 3, 55, 2};
+    const UINT format = Clipboard_register_format(L"testing_many");
+    const Clipboard_item items[] = {
+        {CF_TEXT, (const uint8_t*)text, sizeof(text)},
+        {CF_UNICODETEXT, (const uint8_t*)wide_text, sizeof(wide_text)},
+        {format, data, sizeof(data)}
+    };
+    char extract_text[50] = {0};
+    wchar_t extract_wide_text[50] = {0};
+    uint8_t extract_data[50] = {0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    cr_assert(Clipboard_set_many(items, sizeof(items) / sizeof(items[0])), "Cannot set clipboard content");
+
+    cr_assert(Clipboard_is_format_avail(CF_TEXT), "Text format isn't available!");
+    cr_assert(Clipboard_is_format_avail(CF_UNICODETEXT), "Unicode text format isn't available!");
+    cr_assert(Clipboard_is_format_avail(format), "Custom format isn't available!");
+
+    cr_assert_eq(Clipboard_get(CF_TEXT, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+    cr_assert_eq(Clipboard_get(CF_UNICODETEXT, (uint8_t*)extract_wide_text, sizeof(extract_wide_text)), sizeof(wide_text));
+    cr_assert_eq(Clipboard_get(format, extract_data, sizeof(extract_data)), sizeof(data));
+
+    cr_assert(!Clipboard_set_many(items, 0), "Setting nothing should fail");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_str_eq(extract_text, text);
+    cr_assert_wcs_eq(extract_wide_text, wide_text);
+    cr_assert_arr_eq(extract_data, data, sizeof(data));
+}
+
+static size_t lazy_render_count = 0;
+
+static bool lazy_render_text(void *ctx, Clipboard_item *item) {
+    lazy_render_count++;
+    item->ptr = (const uint8_t*)ctx;
+    item->size = strlen((const char*)ctx) + 1;
+    return true;
+}
+
+/**
+ * Test delayed rendering of clipboard content.
+ */
+Test(clipboard, set_clipboard_lazy) {
+    const char text[] = "For my waifu!";
+    const UINT format = Clipboard_register_format(L"testing_lazy");
+    const Clipboard_lazy_item items[] = {
+        {CF_TEXT, lazy_render_text, (void*)text},
+        {format, lazy_render_text, (void*)text}
+    };
+    char extract_text[50] = {0};
+
+    lazy_render_count = 0;
+
+    cr_assert(Clipboard_lazy_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_lazy(items, sizeof(items) / sizeof(items[0])), "Cannot set lazy clipboard content");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_eq(lazy_render_count, 0, "Nothing should be rendered before request");
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_is_format_avail(CF_TEXT), "Text format isn't available!");
+    cr_assert_eq(Clipboard_get(CF_TEXT, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+    cr_assert_eq(Clipboard_get(CF_TEXT, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_str_eq(extract_text, text);
+    cr_assert_eq(lazy_render_count, 1, "Only requested format should be rendered once");
+
+    Clipboard_lazy_destroy();
+    cr_assert_eq(lazy_render_count, 2, "Remaining format should be rendered on destroy");
+}
+
+/**
+ * Test view into clipboard content without copying it.
+ */
+Test(clipboard, view_clipboard_text) {
+    const DWORD format = CF_TEXT;
+    const char text[] = "For my waifu!";
+    const size_t text_len = sizeof(text);
+    Clipboard_view view;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+
+    cr_assert(Clipboard_view_acquire(format, &view), "Cannot acquire clipboard view");
+    cr_assert_eq(view.size, text_len, "Unexpected size of clipboard's view!");
+    cr_assert_str_eq((const char*)view.data, text);
+
+    Clipboard_view_release(&view);
+    cr_assert_null(view.data, "View should be reset on release");
+    cr_assert_eq(view.size, 0, "View should be reset on release");
+
+    cr_assert(!Clipboard_view_acquire(CF_UNICODETEXT + 100, &view), "Should fail on absent format");
+    cr_assert_null(view.data, "View should be empty on failure");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
 /**
  * Test empty clipboard.
  */
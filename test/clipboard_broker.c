@@ -0,0 +1,201 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+static const Clipboard_backend *old_backend = NULL;
+
+static void setup() {
+    Clipboard_mem_reset();
+    old_backend = Clipboard_set_backend(&Clipboard_backend_mem);
+}
+
+static void teardown() {
+    Clipboard_set_backend(old_backend);
+    Clipboard_mem_reset();
+}
+
+TestSuite(clipboard_broker, .init = setup, .fini = teardown);
+
+static size_t count_formats(void *ctx) {
+    (void)ctx;
+    return Clipboard_count_avail_formats();
+}
+
+/**
+ * Test each kind of request.
+ */
+Test(clipboard_broker, requests) {
+    Clipboard_broker *broker = Clipboard_broker_start(100);
+    const char text[] = "For my waifu!";
+    char extract_text[50] = {0};
+    UINT formats[4] = {0};
+
+    cr_assert_neq(broker, NULL, "Cannot start broker");
+
+    Clipboard_request set = {.type = CLIPBOARD_REQUEST_SET, .format = CF_TEXT, .data = (uint8_t*)text, .size = sizeof(text)};
+    cr_assert_eq(Clipboard_broker_call(broker, &set), 1, "Cannot set clipboard text");
+
+    Clipboard_request get_size = {.type = CLIPBOARD_REQUEST_GET_SIZE, .format = CF_TEXT};
+    cr_assert_eq(Clipboard_broker_call(broker, &get_size), sizeof(text));
+
+    Clipboard_request get = {.type = CLIPBOARD_REQUEST_GET, .format = CF_TEXT, .data = (uint8_t*)extract_text, .size = sizeof(extract_text)};
+    cr_assert_eq(Clipboard_broker_call(broker, &get), sizeof(text));
+    cr_assert_str_eq(extract_text, text);
+
+    Clipboard_request list = {.type = CLIPBOARD_REQUEST_FORMATS, .formats = formats, .size = 4};
+    cr_assert_eq(Clipboard_broker_call(broker, &list), 1, "Only one format should present");
+    cr_assert_eq(formats[0], CF_TEXT);
+
+    Clipboard_request call = {.type = CLIPBOARD_REQUEST_CALL, .fn = count_formats};
+    cr_assert_eq(Clipboard_broker_call(broker, &call), 1);
+
+    const Clipboard_broker_stats stats = Clipboard_broker_get_stats(broker);
+    cr_assert_eq(stats.requests, 5);
+    cr_assert_eq(stats.batches, 5);
+
+    Clipboard_broker_stop(broker);
+}
+
+typedef struct {
+    Clipboard_broker *broker;
+    size_t requests;
+    size_t failures;
+} worker_ctx;
+
+#define WORKERS 4
+#define WORKER_REQUESTS 200
+
+static DWORD WINAPI worker(LPVOID param) {
+    worker_ctx *ctx = (worker_ctx*)param;
+
+    for (size_t idx = 0; idx < ctx->requests; idx++) {
+        char text[16] = {0};
+        Clipboard_request get = {.type = CLIPBOARD_REQUEST_GET, .format = CF_TEXT, .data = (uint8_t*)text, .size = sizeof(text)};
+
+        if (Clipboard_broker_call(ctx->broker, &get) != sizeof("Shared") || strcmp(text, "Shared") != 0) ctx->failures++;
+    }
+
+    return 0;
+}
+
+/**
+ * Test requests from multiple threads and their batching.
+ */
+Test(clipboard_broker, threads) {
+    Clipboard_broker *broker = Clipboard_broker_start(100);
+    const char text[] = "Shared";
+    worker_ctx ctx[WORKERS];
+    HANDLE threads[WORKERS];
+
+    cr_assert_neq(broker, NULL, "Cannot start broker");
+
+    Clipboard_request set = {.type = CLIPBOARD_REQUEST_SET, .format = CF_TEXT, .data = (uint8_t*)text, .size = sizeof(text)};
+    cr_assert_eq(Clipboard_broker_call(broker, &set), 1, "Cannot set clipboard text");
+
+    for (size_t idx = 0; idx < WORKERS; idx++) {
+        ctx[idx].broker = broker;
+        ctx[idx].requests = WORKER_REQUESTS;
+        ctx[idx].failures = 0;
+        threads[idx] = CreateThread(NULL, 0, worker, &ctx[idx], 0, NULL);
+        cr_assert_neq(threads[idx], NULL, "Cannot start worker");
+    }
+
+    for (size_t idx = 0; idx < WORKERS; idx++) {
+        WaitForSingleObject(threads[idx], INFINITE);
+        CloseHandle(threads[idx]);
+        cr_assert_eq(ctx[idx].failures, 0, "Worker got unexpected content");
+    }
+
+    const Clipboard_broker_stats stats = Clipboard_broker_get_stats(broker);
+    cr_assert_eq(stats.requests, 1 + WORKERS * WORKER_REQUESTS);
+    cr_assert_leq(stats.batches, stats.requests);
+
+    Clipboard_broker_stop(broker);
+}
+
+/** Lock of threads that access clipboard on their own. */
+static SRWLOCK mutex_lock = SRWLOCK_INIT;
+
+/**
+ * Worker that opens clipboard for each request under global lock.
+ */
+static DWORD WINAPI mutex_worker(LPVOID param) {
+    worker_ctx *ctx = (worker_ctx*)param;
+
+    for (size_t idx = 0; idx < ctx->requests; idx++) {
+        char text[16] = {0};
+
+        AcquireSRWLockExclusive(&mutex_lock);
+        if (Clipboard_open()) {
+            if (Clipboard_get(CF_TEXT, (uint8_t*)text, sizeof(text)) != sizeof("Shared") || strcmp(text, "Shared") != 0) ctx->failures++;
+            (void)Clipboard_close();
+        }
+        else {
+            ctx->failures++;
+        }
+        ReleaseSRWLockExclusive(&mutex_lock);
+    }
+
+    return 0;
+}
+
+#define BENCH_WORKERS 8
+#define BENCH_REQUESTS 20000
+
+/**
+ * Runs workers to completion.
+ *
+ * @return Elapsed time in seconds.
+ */
+static double bench_run(LPTHREAD_START_ROUTINE fn, Clipboard_broker *broker) {
+    worker_ctx ctx[BENCH_WORKERS];
+    HANDLE threads[BENCH_WORKERS];
+    LARGE_INTEGER frequency, start, end;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&start);
+
+    for (size_t idx = 0; idx < BENCH_WORKERS; idx++) {
+        ctx[idx].broker = broker;
+        ctx[idx].requests = BENCH_REQUESTS;
+        ctx[idx].failures = 0;
+        threads[idx] = CreateThread(NULL, 0, fn, &ctx[idx], 0, NULL);
+        cr_assert_neq(threads[idx], NULL, "Cannot start worker");
+    }
+
+    for (size_t idx = 0; idx < BENCH_WORKERS; idx++) {
+        WaitForSingleObject(threads[idx], INFINITE);
+        CloseHandle(threads[idx]);
+        cr_assert_eq(ctx[idx].failures, 0, "Worker got unexpected content");
+    }
+
+    (void)QueryPerformanceCounter(&end);
+    return (double)(end.QuadPart - start.QuadPart) / (double)frequency.QuadPart;
+}
+
+/**
+ * Compares throughput of broker with threads that serialize on global lock.
+ */
+Test(clipboard_broker, throughput_against_mutex) {
+    const double requests = (double)BENCH_WORKERS * BENCH_REQUESTS;
+    const char text[] = "Shared";
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    const double mutex_time = bench_run(mutex_worker, NULL);
+
+    Clipboard_broker *broker = Clipboard_broker_start(100);
+    cr_assert_neq(broker, NULL, "Cannot start broker");
+
+    const double broker_time = bench_run(worker, broker);
+    const Clipboard_broker_stats stats = Clipboard_broker_get_stats(broker);
+
+    Clipboard_broker_stop(broker);
+
+    cr_assert_eq(stats.requests, BENCH_WORKERS * BENCH_REQUESTS);
+    cr_log_info("mutex: %.0f requests/s, 1 request per open", requests / mutex_time);
+    cr_log_info("broker: %.0f requests/s, %.1f requests per open",
+                requests / broker_time, (double)stats.requests / (double)stats.batches);
+}
@@ -0,0 +1,143 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+static void set_text(const char *text) {
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test that unchanged clipboard is served from cache.
+ */
+Test(clipboard_cache, hit_on_same_seq_num) {
+    const char text[] = "For my waifu!";
+    Clipboard_cache cache;
+    size_t size = 0;
+
+    set_text(text);
+    Clipboard_cache_init(&cache, 1024);
+
+    const uint8_t *first = Clipboard_cache_get(&cache, CF_TEXT, &size);
+    cr_assert_not_null(first, "Failed to get clipboard text");
+    cr_assert_eq(size, sizeof(text));
+    cr_assert_str_eq((const char*)first, text);
+
+    const uint8_t *second = Clipboard_cache_get(&cache, CF_TEXT, &size);
+    cr_assert_eq(second, first, "Expected the same cached content");
+
+    const Clipboard_cache_stats stats = Clipboard_cache_get_stats(&cache);
+    cr_assert_eq(stats.hits, 1);
+    cr_assert_eq(stats.misses, 1);
+    cr_assert_eq(stats.used, sizeof(text));
+
+    Clipboard_cache_clear(&cache);
+    cr_assert_eq(Clipboard_cache_get_stats(&cache).used, 0);
+}
+
+/**
+ * Test that change of clipboard invalidates cache.
+ */
+Test(clipboard_cache, miss_on_new_seq_num) {
+    const char text[] = "For my waifu!";
+    const char new_text[] = "Not my waifu!";
+    Clipboard_cache cache;
+    size_t size = 0;
+
+    set_text(text);
+    Clipboard_cache_init(&cache, 1024);
+
+    cr_assert_not_null(Clipboard_cache_get(&cache, CF_TEXT, &size));
+
+    set_text(new_text);
+
+    const uint8_t *content = Clipboard_cache_get(&cache, CF_TEXT, &size);
+    cr_assert_not_null(content, "Failed to get clipboard text");
+    cr_assert_str_eq((const char*)content, new_text);
+    cr_assert_eq(Clipboard_cache_get_stats(&cache).misses, 2);
+
+    Clipboard_cache_clear(&cache);
+}
+
+/**
+ * Test that absence of format is cached too.
+ */
+Test(clipboard_cache, absent_format) {
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const UINT format1 = Clipboard_register_format(L"cache_testing1");
+    const UINT format2 = Clipboard_register_format(L"cache_testing2");
+    Clipboard_cache cache;
+    size_t size = 0;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format1, data, sizeof(data)), "Cannot set clipboard data");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    Clipboard_cache_init(&cache, sizeof(data));
+
+    cr_assert_not_null(Clipboard_cache_get(&cache, format1, &size));
+    cr_assert_null(Clipboard_cache_get(&cache, format2, &size), "Format shouldn't be available");
+    cr_assert_eq(size, 0);
+    cr_assert_null(Clipboard_cache_get(&cache, format2, &size), "Format shouldn't be available");
+    cr_assert_not_null(Clipboard_cache_get(&cache, format1, &size));
+
+    const Clipboard_cache_stats stats = Clipboard_cache_get_stats(&cache);
+    cr_assert_eq(stats.hits, 2);
+    cr_assert_eq(stats.misses, 2);
+    cr_assert_eq(stats.evictions, 0);
+    cr_assert_eq(stats.used, sizeof(data));
+
+    Clipboard_cache_clear(&cache);
+}
+
+/**
+ * Test eviction of least recently used format.
+ */
+Test(clipboard_cache, evict_lru) {
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const UINT format1 = Clipboard_register_format(L"cache_testing1");
+    const UINT format2 = Clipboard_register_format(L"cache_testing2");
+    const Clipboard_item items[] = {
+        {format1, data, sizeof(data)},
+        {format2, data, sizeof(data)}
+    };
+    Clipboard_cache cache;
+    size_t size = 0;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_many(items, sizeof(items) / sizeof(items[0])), "Cannot set clipboard data");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    Clipboard_cache_init(&cache, sizeof(data));
+
+    cr_assert_not_null(Clipboard_cache_get(&cache, format1, &size));
+    cr_assert_not_null(Clipboard_cache_get(&cache, format2, &size));
+    cr_assert_not_null(Clipboard_cache_get(&cache, format1, &size));
+
+    const Clipboard_cache_stats stats = Clipboard_cache_get_stats(&cache);
+    cr_assert_eq(stats.hits, 0);
+    cr_assert_eq(stats.misses, 3);
+    cr_assert_eq(stats.evictions, 2);
+    cr_assert_eq(stats.used, sizeof(data));
+
+    Clipboard_cache_clear(&cache);
+}
+
+/**
+ * Test content bigger than capacity isn't cached.
+ */
+Test(clipboard_cache, too_big) {
+    const char text[] = "For my waifu!";
+    Clipboard_cache cache;
+    size_t size = 0;
+
+    set_text(text);
+    Clipboard_cache_init(&cache, sizeof(text) - 1);
+
+    cr_assert_null(Clipboard_cache_get(&cache, CF_TEXT, &size));
+    cr_assert_eq(size, sizeof(text), "Size of content should be reported");
+    cr_assert_eq(Clipboard_cache_get_stats(&cache).used, 0);
+
+    Clipboard_cache_clear(&cache);
+}
@@ -0,0 +1,759 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+static const Clipboard_backend *old_backend = NULL;
+
+static void setup() {
+    Clipboard_mem_reset();
+    old_backend = Clipboard_set_backend(&Clipboard_backend_mem);
+}
+
+static void teardown() {
+    Clipboard_set_backend(old_backend);
+    Clipboard_mem_reset();
+}
+
+TestSuite(clipboard_mem, .init = setup, .fini = teardown);
+
+/**
+ * Test setting of text.
+ */
+Test(clipboard_mem, set_text) {
+    const DWORD format = CF_TEXT;
+    const char text[] = "For my waifu!";
+    char extract_text[50] = {0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+
+    cr_assert_eq(Clipboard_next_avail_format(), format, "Next available format should text");
+    cr_assert(Clipboard_is_format_avail(format), "Text format isn't available!");
+    cr_assert_eq(Clipboard_count_avail_formats(), 1, "Only one format should present");
+    cr_assert_eq(Clipboard_get_size(format), sizeof(text), "Unexpected size of clipboard's data!");
+    cr_assert_eq(Clipboard_get(format, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+
+    cr_assert(Clipboard_empty(), "Failed to empty clipboard");
+    cr_assert_eq(Clipboard_count_avail_formats(), 0, "No formats should present on clipboard");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_str_eq(extract_text, text);
+}
+
+typedef struct {
+    uint8_t data[64];
+    size_t len;
+    size_t chunks;
+} chunk_sink;
+
+static bool collect_chunk(void *ctx, const uint8_t *chunk, size_t size, size_t offset) {
+    chunk_sink *sink = (chunk_sink*)ctx;
+
+    cr_assert_eq(offset, sink->len, "Chunks should be sequential");
+    memcpy(sink->data + sink->len, chunk, size);
+    sink->len += size;
+    sink->chunks++;
+    return true;
+}
+
+static bool stop_chunk(void *ctx, const uint8_t *chunk, size_t size, size_t offset) {
+    (void)ctx;
+    (void)chunk;
+    (void)size;
+    (void)offset;
+    return false;
+}
+
+/**
+ * Test reading of content by chunks.
+ */
+Test(clipboard_mem, get_chunks) {
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    const UINT format = Clipboard_register_format(L"testing_chunks");
+    chunk_sink sink = {0};
+    uint8_t part[4] = {0};
+    Clipboard_view view;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format, data, sizeof(data)), "Cannot set clipboard data");
+
+    cr_assert_eq(Clipboard_get_chunks(format, 4, collect_chunk, &sink), sizeof(data));
+    cr_assert_eq(sink.chunks, 3);
+    cr_assert_arr_eq(sink.data, data, sizeof(data));
+
+    cr_assert_eq(Clipboard_get_chunks(format, 4, stop_chunk, NULL), 0, "Nothing should be consumed");
+    cr_assert_eq(Clipboard_get_chunks(format, 0, collect_chunk, &sink), 0, "Chunk size cannot be 0");
+
+    cr_assert(Clipboard_view_acquire(format, &view), "Cannot acquire clipboard view");
+    cr_assert_eq(Clipboard_view_read(&view, 8, part, sizeof(part)), 3, "Read should be truncated by content");
+    cr_assert_arr_eq(part, data + 8, 3);
+    cr_assert_eq(Clipboard_view_read(&view, sizeof(data), part, sizeof(part)), 0);
+    Clipboard_view_release(&view);
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test reading of content into allocated memory.
+ */
+Test(clipboard_mem, get_alloc) {
+    const char text[] = "For my waifu!";
+    uint8_t buffer[32];
+    Clipboard_arena arena = {buffer, sizeof(buffer), 0};
+    const Clipboard_allocator arena_allocator = {Clipboard_arena_alloc, &arena};
+    size_t size = 0;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+
+    uint8_t *content = Clipboard_get_alloc(CF_TEXT, NULL, &size);
+    cr_assert_not_null(content, "Cannot get clipboard text");
+    cr_assert_eq(size, sizeof(text));
+    cr_assert_str_eq((const char*)content, text);
+    free(content);
+
+    content = Clipboard_get_alloc(CF_TEXT, &arena_allocator, &size);
+    cr_assert_eq(content, buffer, "Content should be allocated from arena");
+    cr_assert_str_eq((const char*)content, text);
+
+    cr_assert_not_null(Clipboard_get_alloc(CF_TEXT, &arena_allocator, &size));
+    cr_assert_null(Clipboard_get_alloc(CF_TEXT, &arena_allocator, &size), "Arena should be exhausted");
+    cr_assert_eq(size, 0);
+
+    arena.used = 0;
+    cr_assert_eq(Clipboard_get_alloc(CF_TEXT, &arena_allocator, &size), buffer, "Arena should be reused");
+
+    cr_assert_null(Clipboard_get_alloc(CF_UNICODETEXT, NULL, &size), "Format shouldn't be available");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test exchange of UTF-8 text.
+ */
+Test(clipboard_mem, utf8) {
+    /* "Aя€" */
+    const char text[] = "A\xD1\x8F\xE2\x82\xAC";
+    const wchar_t wide_text[] = L"A\x44F\x20AC";
+    wchar_t extract_wide_text[8] = {0};
+    char extract_text[8] = {0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_utf8(text), "Cannot set clipboard text");
+
+    cr_assert_eq(Clipboard_get_size(CF_UNICODETEXT), sizeof(wide_text));
+    cr_assert_eq(Clipboard_get(CF_UNICODETEXT, (uint8_t*)extract_wide_text, sizeof(extract_wide_text)), sizeof(wide_text));
+    cr_assert_wcs_eq(extract_wide_text, wide_text);
+
+    cr_assert_eq(Clipboard_get_utf8(NULL, 0), sizeof(text) - 1);
+    cr_assert_eq(Clipboard_get_utf8(extract_text, sizeof(extract_text)), sizeof(text) - 1);
+    cr_assert_str_eq(extract_text, text);
+
+    cr_assert_eq(Clipboard_get_utf8(extract_text, 4), 3, "Text should be truncated without splitting code points");
+    cr_assert_str_eq(extract_text, "A\xD1\x8F");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test filling of clipboard memory in place.
+ */
+Test(clipboard_mem, reserve_commit) {
+    const char text[] = "For my waifu!";
+    char extract_text[50] = {0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    char *reserved = (char*)Clipboard_reserve(CF_TEXT, 64);
+    cr_assert_not_null(reserved, "Cannot reserve clipboard memory");
+    cr_assert_null(Clipboard_reserve(CF_TEXT, 64), "Only one reservation should be allowed");
+    memcpy(reserved, text, sizeof(text));
+    cr_assert(Clipboard_commit(sizeof(text)), "Cannot commit clipboard memory");
+    cr_assert_not(Clipboard_commit(sizeof(text)), "Commit without reservation should fail");
+
+    cr_assert_eq(Clipboard_get_size(CF_TEXT), sizeof(text), "Memory should be shrunk to committed size");
+    cr_assert_eq(Clipboard_get(CF_TEXT, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+
+    cr_assert_not_null(Clipboard_reserve(CF_OEMTEXT, 8), "Cannot reserve clipboard memory");
+    cr_assert_not(Clipboard_commit(9), "Commit over capacity should fail");
+
+    cr_assert_not_null(Clipboard_reserve(CF_OEMTEXT, 8), "Cannot reserve clipboard memory");
+    cr_assert_not(Clipboard_commit(0), "Empty commit should fail");
+    cr_assert_not(Clipboard_is_format_avail(CF_OEMTEXT), "Empty memory should not be published");
+
+    cr_assert_not_null(Clipboard_reserve(CF_OEMTEXT, 8), "Cannot reserve clipboard memory");
+    Clipboard_cancel();
+    cr_assert_not(Clipboard_is_format_avail(CF_OEMTEXT), "Cancelled memory should not be published");
+    cr_assert(Clipboard_is_format_avail(CF_TEXT), "Clipboard should be untouched");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_str_eq(extract_text, text);
+}
+
+/**
+ * Test conversion of line endings of clipboard text.
+ */
+Test(clipboard_mem, newline) {
+    char text[50] = {0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    cr_assert(Clipboard_set_string_newline("For\nmy\r\nwaifu!", CLIPBOARD_NEWLINE_CRLF));
+    cr_assert_eq(Clipboard_get_size(CF_TEXT), sizeof("For\r\nmy\r\nwaifu!"), "Memory should be sized exactly");
+    cr_assert_eq(Clipboard_get_string(NULL, 0, CLIPBOARD_NEWLINE_KEEP), sizeof("For\r\nmy\r\nwaifu!") - 1);
+    cr_assert_eq(Clipboard_get_string(text, sizeof(text), CLIPBOARD_NEWLINE_KEEP), sizeof("For\r\nmy\r\nwaifu!") - 1);
+    cr_assert_str_eq(text, "For\r\nmy\r\nwaifu!");
+
+    cr_assert_eq(Clipboard_get_string(NULL, 0, CLIPBOARD_NEWLINE_LF), sizeof("For\nmy\nwaifu!") - 1);
+    cr_assert_eq(Clipboard_get_string(text, sizeof(text), CLIPBOARD_NEWLINE_LF), sizeof("For\nmy\nwaifu!") - 1);
+    cr_assert_str_eq(text, "For\nmy\nwaifu!");
+
+    cr_assert_eq(Clipboard_get_string(text, 5, CLIPBOARD_NEWLINE_LF), 4);
+    cr_assert_str_eq(text, "For\n");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test transparent compression of registered format.
+ */
+Test(clipboard_mem, compressed_format) {
+    const UINT format = Clipboard_register_format(L"lazy_winapi_compressed");
+    uint8_t data[2048];
+    uint8_t extract_data[2048] = {0};
+    size_t alloc_size = 0;
+
+    for (size_t idx = 0; idx < sizeof(data); idx++) data[idx] = (uint8_t)(idx % 64);
+
+    cr_assert_not(Clipboard_set_format_compressed(CF_TEXT, true), "Only registered formats can be compressed");
+    cr_assert(Clipboard_set_format_compressed(format, true));
+    cr_assert(Clipboard_is_format_compressed(format));
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format, data, sizeof(data)), "Cannot set clipboard data");
+
+    cr_assert_eq(Clipboard_get_size(format), sizeof(data), "Size before compression should be reported");
+    cr_assert_eq(Clipboard_get(format, extract_data, sizeof(extract_data)), sizeof(data));
+    cr_assert_arr_eq(extract_data, data, sizeof(data));
+
+    uint8_t *alloc_data = Clipboard_get_alloc(format, NULL, &alloc_size);
+    cr_assert_eq(alloc_size, sizeof(data));
+    cr_assert_arr_eq(alloc_data, data, sizeof(data));
+    free(alloc_data);
+
+    Clipboard_format_info info;
+    cr_assert_eq(Clipboard_snapshot_formats(&info, 1, NULL, 0), 1);
+    cr_assert_eq(info.size, sizeof(data), "Snapshot should report size before compression");
+
+    cr_assert(Clipboard_set_format_compressed(format, false));
+    cr_assert_lt(Clipboard_get_size(format), sizeof(data) / 4, "Stored content should be compressed");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test that corrupted compressed content is reported as failure.
+ */
+Test(clipboard_mem, compressed_corrupted) {
+    const UINT format = Clipboard_register_format(L"lazy_winapi_compressed");
+    uint8_t data[2048];
+    uint8_t extract_data[2048];
+    size_t alloc_size = 1;
+
+    for (size_t idx = 0; idx < sizeof(data); idx++) data[idx] = (uint8_t)(idx % 64);
+
+    cr_assert(Clipboard_set_format_compressed(format, true));
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format, data, sizeof(data)), "Cannot set clipboard data");
+
+    /* Cut stream after header and the first literals. */
+    Clipboard_view view;
+    cr_assert(Clipboard_view_acquire(format, &view));
+    cr_assert_gt(view.size, 16 + 16);
+    memcpy(extract_data, view.data, 16 + 16);
+    Clipboard_view_release(&view);
+
+    cr_assert(Clipboard_set_format_compressed(format, false));
+    cr_assert(Clipboard_set(format, extract_data, 16 + 16), "Cannot set clipboard data");
+    cr_assert(Clipboard_set_format_compressed(format, true));
+
+    cr_assert_eq(Clipboard_get_size(format), sizeof(data), "Size comes from header");
+    cr_assert_eq(Clipboard_get(format, extract_data, sizeof(extract_data)), 0, "Truncated content should fail");
+    cr_assert_null(Clipboard_get_alloc(format, NULL, &alloc_size), "Truncated content should fail");
+    cr_assert_eq(alloc_size, 0);
+
+    cr_assert(Clipboard_set_format_compressed(format, false));
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test that compressed content with forged size is treated as raw.
+ */
+Test(clipboard_mem, compressed_forged_size) {
+    const UINT format = Clipboard_register_format(L"lazy_winapi_compressed");
+    /* Signature `LWZ1`, LZ method and size of 4GiB followed by single literal. */
+    const uint8_t data[] = {
+        'L', 'W', 'Z', '1', 1, 0, 0, 0,
+        0, 0, 0, 0, 1, 0, 0, 0,
+        0x10, 'a'
+    };
+    size_t alloc_size = 0;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format, data, sizeof(data)), "Cannot set clipboard data");
+    cr_assert(Clipboard_set_format_compressed(format, true));
+
+    cr_assert_eq(Clipboard_get_size(format), sizeof(data), "Forged size should be ignored");
+
+    uint8_t *alloc_data = Clipboard_get_alloc(format, NULL, &alloc_size);
+    cr_assert_eq(alloc_size, sizeof(data));
+    cr_assert_arr_eq(alloc_data, data, sizeof(data));
+    free(alloc_data);
+
+    cr_assert(Clipboard_set_format_compressed(format, false));
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test iteration over file list within clipboard memory.
+ */
+Test(clipboard_mem, drop) {
+    const uint8_t data[] = {
+        20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        'a', 0, 'b', 'c', 0, 0
+    };
+    Clipboard_drop drop;
+    Drop_path path;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert_not(Clipboard_drop_acquire(&drop), "There should be no file list");
+
+    cr_assert(Clipboard_set(CF_HDROP, data, sizeof(data)), "Cannot set clipboard data");
+    cr_assert(Clipboard_drop_acquire(&drop), "Cannot acquire file list");
+    cr_assert(Drop_iter_next(&drop.iter, &path));
+    cr_assert_eq(path.len, 1);
+    cr_assert(Drop_iter_next(&drop.iter, &path));
+    cr_assert_eq(path.len, 2);
+    cr_assert_arr_eq(path.ansi, "bc", 2);
+    cr_assert_not(Drop_iter_next(&drop.iter, &path));
+    Clipboard_drop_release(&drop);
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test retrieval of clipboard image into caller's buffer.
+ */
+Test(clipboard_mem, image) {
+    /* BITMAPINFOHEADER of top-down 1x2 BGR bitmap, 4 bytes per row. */
+    const uint8_t data[40 + 8] = {
+        40, 0, 0, 0, 1, 0, 0, 0, 0xFE, 0xFF, 0xFF, 0xFF, 1, 0, 24, 0,
+        [40] = 3, 2, 1, 0, 6, 5, 4, 0
+    };
+    const uint8_t expected[] = {1, 2, 3, 0xFF, 4, 5, 6, 0xFF};
+    uint8_t buffer[8];
+    Clipboard_arena arena = {buffer, sizeof(buffer), 0};
+    const Clipboard_allocator allocator = {Clipboard_arena_alloc, &arena};
+    Clipboard_image image;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert_not(Clipboard_get_image(&image, NULL), "There should be no image");
+
+    cr_assert(Clipboard_set(CF_DIB, data, sizeof(data)), "Cannot set clipboard data");
+    cr_assert(Clipboard_get_image(&image, &allocator), "Cannot get image");
+    cr_assert_eq(image.width, 1);
+    cr_assert_eq(image.height, 2);
+    cr_assert_eq(image.pixels, buffer, "Pixels should be in caller's buffer");
+    cr_assert_arr_eq(buffer, expected, sizeof(expected));
+
+    cr_assert_not(Clipboard_get_image(&image, &allocator), "Buffer is exhausted");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test that clipboard can be opened only once.
+ */
+Test(clipboard_mem, ownership) {
+    cr_assert(!Clipboard_close(), "Closed clipboard cannot be closed");
+    cr_assert(!Clipboard_empty(), "Closed clipboard cannot be emptied");
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_open(), "Thread that opened clipboard can open it again");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+    cr_assert(!Clipboard_close(), "Closed clipboard cannot be closed");
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+typedef struct {
+    bool opened;
+    bool closed;
+    bool emptied;
+    bool set;
+    DWORD error;
+} foreign_ctx;
+
+/**
+ * Accesses clipboard that is opened by another thread.
+ */
+static DWORD WINAPI foreign_thread(LPVOID param) {
+    foreign_ctx *ctx = (foreign_ctx*)param;
+    const char text[] = "Intruder";
+
+    ctx->opened = Clipboard_open();
+    ctx->closed = Clipboard_close();
+    ctx->emptied = Clipboard_empty();
+    ctx->error = GetLastError();
+    ctx->set = Clipboard_set_string(text);
+    return 0;
+}
+
+/**
+ * Test that clipboard opened by one thread cannot be used by another.
+ */
+Test(clipboard_mem, ownership_threads) {
+    const char text[] = "For my waifu!";
+    foreign_ctx ctx = {true, true, true, true, 0};
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+
+    const HANDLE thread = CreateThread(NULL, 0, foreign_thread, &ctx, 0, NULL);
+    cr_assert_neq(thread, NULL, "Cannot start thread");
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+
+    cr_assert(!ctx.opened, "Clipboard opened by another thread cannot be opened");
+    cr_assert(!ctx.closed, "Clipboard opened by another thread cannot be closed");
+    cr_assert(!ctx.emptied, "Clipboard opened by another thread cannot be emptied");
+    cr_assert_eq(ctx.error, ERROR_CLIPBOARD_NOT_OPEN);
+    cr_assert(!ctx.set, "Clipboard opened by another thread cannot be set");
+
+    cr_assert_eq(Clipboard_count_avail_formats(), 1, "Content should be intact");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+static DWORD WINAPI contender_thread(LPVOID param) {
+    bool *opened = (bool*)param;
+
+    opened[0] = Clipboard_open_timeout(0);
+    opened[1] = Clipboard_open_timeout(20);
+    return 0;
+}
+
+/**
+ * Test waiting for clipboard with timeout.
+ */
+Test(clipboard_mem, open_timeout) {
+    bool opened[2] = {true, true};
+
+    Clipboard_reset_open_stats();
+
+    cr_assert(Clipboard_open_timeout(0), "Cannot open clipboard");
+
+    /* Only another thread contends for clipboard. */
+    const HANDLE thread = CreateThread(NULL, 0, contender_thread, opened, 0, NULL);
+    cr_assert_neq(thread, NULL, "Cannot start thread");
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+
+    cr_assert(!opened[0], "Opened clipboard cannot be opened");
+    cr_assert(!opened[1], "Opened clipboard cannot be opened");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    const Clipboard_open_stats stats = Clipboard_get_open_stats();
+    cr_assert_eq(stats.calls, 3);
+    cr_assert_eq(stats.contended, 2);
+    cr_assert_eq(stats.timeouts, 2);
+    cr_assert_gt(stats.attempts, 3, "Clipboard should be retried within timeout");
+    cr_assert_geq(stats.waited_us, 20000);
+    cr_assert_eq(stats.histogram[0], 1, "First call should open clipboard immediately");
+    cr_assert_eq(stats.histogram[1], 1, "Second call shouldn't wait");
+
+    size_t recorded = 0;
+    for (size_t idx = 0; idx < CLIPBOARD_OPEN_HISTOGRAM_LEN; idx++) recorded += stats.histogram[idx];
+    cr_assert_eq(recorded, stats.calls, "Each call should be recorded in histogram");
+}
+
+/**
+ * Test sequence number and enumeration of formats.
+ */
+Test(clipboard_mem, seq_num_and_formats) {
+    const char text[] = "For my waifu!";
+    const wchar_t wide_text[] = L"For my waifu!";
+    const Clipboard_item items[] = {
+        {CF_UNICODETEXT, (const uint8_t*)wide_text, sizeof(wide_text)},
+        {CF_TEXT, (const uint8_t*)text, sizeof(text)}
+    };
+    const DWORD seq_num = Clipboard_get_seq_num();
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert_eq(Clipboard_get_seq_num(), seq_num, "Opening shouldn't change sequence number");
+
+    cr_assert(Clipboard_set_many(items, sizeof(items) / sizeof(items[0])), "Cannot set clipboard content");
+    cr_assert_neq(Clipboard_get_seq_num(), seq_num, "Sequence number should change");
+
+    cr_assert_eq(Clipboard_count_avail_formats(), 2);
+    cr_assert_eq(Clipboard_next_avail_format(), CF_UNICODETEXT, "Formats should be enumerated in order of set");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Test snapshot of formats.
+ */
+Test(clipboard_mem, snapshot_formats) {
+    const char text[] = "For my waifu!";
+    const uint8_t data[] = {1, 2, 3};
+    const UINT format = Clipboard_register_format(L"testing_snapshot");
+    const Clipboard_item items[] = {
+        {CF_TEXT, (const uint8_t*)text, sizeof(text)},
+        {format, data, sizeof(data)}
+    };
+    Clipboard_format_info infos[4];
+    wchar_t names[64];
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_many(items, sizeof(items) / sizeof(items[0])), "Cannot set clipboard content");
+
+    cr_assert_eq(Clipboard_snapshot_formats(infos, 4, names, 64), 2);
+    cr_assert_eq(infos[0].format, CF_TEXT);
+    cr_assert_eq(infos[0].size, sizeof(text));
+    cr_assert_wcs_eq(infos[0].name, L"CF_TEXT");
+    cr_assert_eq(infos[1].format, format);
+    cr_assert_eq(infos[1].size, sizeof(data));
+    cr_assert_wcs_eq(infos[1].name, L"testing_snapshot");
+
+    cr_assert_eq(Clipboard_snapshot_formats(infos, 1, names, 10), 2, "Every format should be counted");
+    cr_assert_wcs_eq(infos[0].name, L"CF_TEXT");
+
+    cr_assert_eq(Clipboard_snapshot_formats(infos, 2, NULL, 0), 2);
+    cr_assert_null(infos[1].name, "Name should be NULL without buffer");
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+    cr_assert_eq(Clipboard_snapshot_formats(infos, 4, names, 64), 0, "Closed clipboard cannot be snapshot");
+}
+
+/**
+ * Test registration of format.
+ */
+Test(clipboard_mem, register_format) {
+    const wchar_t format_name[] = L"testing";
+    wchar_t get_format_name[50] = {0};
+    const UINT format = Clipboard_register_format(format_name);
+
+    cr_assert_geq(format, 0xC000, "Couldn't register new format");
+    cr_assert_eq(Clipboard_register_format(format_name), format, "Format should be registered only once");
+    cr_assert_eq(Clipboard_register_format(L"TESTING"), format, "Name of format should be case insensitive");
+    cr_assert_neq(Clipboard_register_format(L"testing2"), format);
+
+    cr_assert_eq(Clipboard_get_format_name(format, get_format_name, sizeof(get_format_name) / sizeof(get_format_name[0])),
+                 wcslen(format_name),
+                 "Failed to get new format name");
+    cr_assert_wcs_eq(get_format_name, format_name);
+}
+
+/**
+ * Test lookup of formats in both directions.
+ */
+Test(clipboard_mem, format_registry) {
+    const UINT format = Clipboard_register_format(L"testing_registry");
+
+    cr_assert_wcs_eq(Clipboard_format_to_name(CF_UNICODETEXT), L"CF_UNICODETEXT");
+    cr_assert_wcs_eq(Clipboard_format_to_name(CF_GDIOBJFIRST + 5), L"CF_GDIOBJ5");
+    cr_assert_wcs_eq(Clipboard_format_to_name(format), L"testing_registry");
+    cr_assert_eq(Clipboard_format_to_name(format), Clipboard_format_to_name(format), "Name should be interned");
+    cr_assert_null(Clipboard_format_to_name(0));
+    cr_assert_null(Clipboard_format_to_name(0xF000 + 666));
+
+    cr_assert_eq(Clipboard_format_from_name(L"CF_UNICODETEXT"), CF_UNICODETEXT);
+    cr_assert_eq(Clipboard_format_from_name(L"cf_text"), CF_TEXT, "Names should be case insensitive");
+    cr_assert_eq(Clipboard_format_from_name(L"CF_PRIVATE255"), CF_PRIVATELAST);
+    cr_assert_eq(Clipboard_format_from_name(L"CF_PRIVATE256"), 0);
+    cr_assert_eq(Clipboard_format_from_name(L"testing_registry"), format);
+    cr_assert_eq(Clipboard_format_from_name(L"testing_unknown"), 0, "Lookup shouldn't register format");
+
+    cr_assert_eq(Clipboard_register_format(L"testing_registry"), format);
+}
+
+static size_t lazy_render_count = 0;
+
+static bool lazy_render_text(void *ctx, Clipboard_item *item) {
+    lazy_render_count++;
+    item->ptr = (const uint8_t*)ctx;
+    item->size = strlen((const char*)ctx) + 1;
+    return true;
+}
+
+/**
+ * Test delayed rendering.
+ */
+Test(clipboard_mem, set_lazy) {
+    const char text[] = "For my waifu!";
+    const Clipboard_lazy_item items[] = {
+        {CF_TEXT, lazy_render_text, (void*)text},
+        {CF_OEMTEXT, lazy_render_text, (void*)text}
+    };
+    char extract_text[50] = {0};
+
+    lazy_render_count = 0;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_empty(), "Failed to empty clipboard");
+    cr_assert(!Clipboard_set_lazy(items, 1), "Delayed rendering requires owner");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert(Clipboard_lazy_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_lazy(items, sizeof(items) / sizeof(items[0])), "Cannot set lazy clipboard content");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert_eq(Clipboard_get(CF_TEXT, (uint8_t*)extract_text, sizeof(extract_text)), sizeof(text));
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_str_eq(extract_text, text);
+    cr_assert_eq(lazy_render_count, 1, "Only requested format should be rendered");
+
+    Clipboard_lazy_destroy();
+    cr_assert_eq(lazy_render_count, 2, "Remaining format should be rendered on destroy");
+}
+
+#define BENCH_SIZE (16 * 1024 * 1024)
+#define BENCH_ROUNDS 4
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Measures setting and getting of content.
+ *
+ * @param[in] name Kind of content to log.
+ */
+static void bench_set_get(const char *name, UINT format, const uint8_t *data, uint8_t *extract_data) {
+    Clipboard_view view;
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+
+    const double set_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert(Clipboard_set(format, data, BENCH_SIZE), "Cannot set clipboard data");
+    }
+    const double set_time = bench_now() - set_start;
+
+    const double get_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(Clipboard_get(format, extract_data, BENCH_SIZE), BENCH_SIZE);
+    }
+    const double get_time = bench_now() - get_start;
+
+    cr_assert_arr_eq(extract_data, data, BENCH_SIZE);
+    cr_assert(Clipboard_view_acquire(format, &view));
+    cr_log_info("%s: set %.0f MB/s, get %.0f MB/s, stored %lu bytes", name,
+                (double)BENCH_SIZE * BENCH_ROUNDS / set_time / 1e6,
+                (double)BENCH_SIZE * BENCH_ROUNDS / get_time / 1e6,
+                (unsigned long)view.size);
+    Clipboard_view_release(&view);
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+}
+
+/**
+ * Measures compressed format against raw one on multi-megabyte content.
+ */
+Test(clipboard_mem, bench_compressed) {
+    const char *words[] = {"clipboard ", "format ", "global ", "memory ", "waifu ", "lazy ", "winapi ", "data\n"};
+    const UINT format = Clipboard_register_format(L"lazy_winapi_compressed");
+    uint8_t *data = (uint8_t*)malloc(BENCH_SIZE);
+    uint8_t *extract_data = (uint8_t*)malloc(BENCH_SIZE);
+    uint32_t seed = 1;
+
+    cr_assert_not_null(data);
+    cr_assert_not_null(extract_data);
+
+    for (size_t len = 0; len < BENCH_SIZE;) {
+        seed = seed * 1103515245 + 12345;
+
+        const char *word = words[(seed >> 16) % 8];
+        const size_t word_len = strlen(word) < BENCH_SIZE - len ? strlen(word) : BENCH_SIZE - len;
+
+        memcpy(data + len, word, word_len);
+        len += word_len;
+    }
+
+    bench_set_get("raw", format, data, extract_data);
+
+    cr_assert(Clipboard_set_format_compressed(format, true));
+    bench_set_get("compressed", format, data, extract_data);
+    cr_assert(Clipboard_set_format_compressed(format, false));
+
+    free(data);
+    free(extract_data);
+}
+
+/**
+ * @return Sum of bytes, standing in for single pass over content.
+ */
+static uint64_t bench_scan(const uint8_t *data, size_t size) {
+    uint64_t result = 0;
+
+    for (size_t idx = 0; idx < size; idx++) result += data[idx];
+    return result;
+}
+
+/**
+ * Measures scan of content through view against copying path.
+ */
+Test(clipboard_mem, bench_view) {
+    const UINT format = Clipboard_register_format(L"lazy_winapi_view");
+    uint8_t *data = (uint8_t*)malloc(BENCH_SIZE);
+    uint8_t *copy = (uint8_t*)malloc(BENCH_SIZE);
+    uint64_t copy_sum = 0;
+    uint64_t view_sum = 0;
+    Clipboard_view view;
+
+    cr_assert_not_null(data);
+    cr_assert_not_null(copy);
+
+    for (size_t idx = 0; idx < BENCH_SIZE; idx++) data[idx] = (uint8_t)(idx * 7);
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set(format, data, BENCH_SIZE), "Cannot set clipboard data");
+
+    const double copy_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(Clipboard_get(format, copy, BENCH_SIZE), BENCH_SIZE);
+        copy_sum += bench_scan(copy, BENCH_SIZE);
+    }
+    const double copy_time = bench_now() - copy_start;
+
+    const double view_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert(Clipboard_view_acquire(format, &view));
+        view_sum += bench_scan(view.data, view.size);
+        Clipboard_view_release(&view);
+    }
+    const double view_time = bench_now() - view_start;
+
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert_eq(view_sum, copy_sum);
+    cr_log_info("view: %.0f MB/s, copy: %.0f MB/s",
+                (double)BENCH_SIZE * BENCH_ROUNDS / view_time / 1e6,
+                (double)BENCH_SIZE * BENCH_ROUNDS / copy_time / 1e6);
+
+    free(data);
+    free(copy);
+}
@@ -75,6 +75,34 @@ Test(clipboard_mock, get_fail_no_lock) {
     mmk_reset(GlobalLock);
 }
 
+/**
+ * Test try to acquire view of clipboard text
+ *
+ * GetClipboardData mock returns dummy.
+ * GlobalLock mock returns NULL
+ */
+Test(clipboard_mock, view_fail_no_lock) {
+    Clipboard_view view;
+
+    int mock_data = 1;
+
+    CREATE_MOCK(GetClipboardData);
+    mmk_when(GetClipboardData(format), .then_return = MOCK_RETURN_PTR(mock_data, HANDLE) );
+
+    CREATE_MOCK(GlobalLock);
+    mmk_when(GlobalLock(mmk_eq(HGLOBAL, &mock_data)), .then_return = NULL);
+
+    cr_assert(!Clipboard_view_acquire(format, &view), "Should fail to acquire view!");
+    cr_assert_null(view.data, "View should be empty on failure");
+    cr_assert_eq(view.size, 0, "View should be empty on failure");
+
+    cr_assert(mmk_verify(GlobalLock(mmk_eq(HGLOBAL, &mock_data)), .times = 1),
+              "GlobalLock incorrect invokation");
+
+    mmk_reset(GetClipboardData);
+    mmk_reset(GlobalLock);
+}
+
 /**
  * Test try to set text.
  *
@@ -94,6 +122,29 @@ Test(clipboard_mock, set_fail_no_memory) {
     mmk_reset(GlobalAlloc);
 }
 
+/**
+ * Test try to set multiple formats.
+ *
+ * GlobalAlloc mock returns NULL
+ */
+Test(clipboard_mock, set_many_fail_no_memory) {
+    const char text[] = "Mock!";
+    const wchar_t wide_text[] = L"Mock!";
+    const Clipboard_item items[] = {
+        {CF_TEXT, (const uint8_t*)text, sizeof(text)},
+        {CF_UNICODETEXT, (const uint8_t*)wide_text, sizeof(wide_text)}
+    };
+
+    CREATE_MOCK(GlobalAlloc);
+    mmk_when(GlobalAlloc(mmk_any(UINT), mmk_any(SIZE_T)), .then_return = NULL);
+
+    cr_assert_eq(Clipboard_set_many(items, sizeof(items) / sizeof(items[0])), 0, "Should fail to set clipboard!");
+
+    mmk_reset(GlobalAlloc);
+
+    cr_assert(Clipboard_is_format_avail(format), "Clipboard shouldn't be emptied on allocation failure!");
+}
+
 /**
  * Test try to set text.
  *
@@ -0,0 +1,126 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+/**
+ * Test that wait times out without updates.
+ */
+Test(clipboard_watch, wait_timeout) {
+    Clipboard_watch *watch = Clipboard_watch_start(NULL, NULL, 0);
+    size_t seen = 0;
+
+    cr_assert_not_null(watch, "Cannot start watcher");
+    cr_assert(!Clipboard_watch_wait(watch, &seen, 10), "Shouldn't be notified without updates");
+
+    Clipboard_watch_stop(watch);
+}
+
+/**
+ * Test notification on clipboard change.
+ */
+Test(clipboard_watch, wait_clipboard_change) {
+    const char text[] = "For my waifu!";
+    Clipboard_watch *watch = Clipboard_watch_start(NULL, NULL, 0);
+    size_t seen = 0;
+
+    cr_assert_not_null(watch, "Cannot start watcher");
+
+    cr_assert(Clipboard_open(), "Cannot open clipboard");
+    cr_assert(Clipboard_set_string(text), "Cannot set clipboard text");
+    cr_assert(Clipboard_close(), "Cannot close clipboard");
+
+    cr_assert(Clipboard_watch_wait(watch, &seen, 1000), "Should be notified about change");
+    cr_assert(!Clipboard_watch_wait(watch, &seen, 0), "Notification should be seen already");
+
+    Clipboard_watch_stop(watch);
+}
+
+/**
+ * Test that burst of updates is coalesced.
+ */
+Test(clipboard_watch, coalesce_burst) {
+    const size_t burst = 5;
+    Clipboard_watch *watch = Clipboard_watch_start(NULL, NULL, 100);
+    size_t seen = 0;
+
+    cr_assert_not_null(watch, "Cannot start watcher");
+
+    for (size_t idx = 0; idx < burst; idx++) {
+        cr_assert(Clipboard_watch_fire(watch), "Cannot fire update");
+    }
+
+    cr_assert(Clipboard_watch_wait(watch, &seen, 1000), "Should be notified about burst");
+
+    const Clipboard_watch_stats stats = Clipboard_watch_get_stats(watch);
+    cr_assert_eq(stats.updates, burst);
+    cr_assert_eq(stats.notifications, 1);
+
+    Clipboard_watch_stop(watch);
+}
+
+static volatile LONG watch_callback_updates = 0;
+
+static void watch_callback(void *ctx, size_t updates) {
+    (void)ctx;
+    InterlockedExchangeAdd(&watch_callback_updates, (LONG)updates);
+}
+
+/**
+ * Test callback mode.
+ */
+Test(clipboard_watch, callback) {
+    Clipboard_watch *watch = Clipboard_watch_start(watch_callback, NULL, 0);
+    size_t seen = 0;
+
+    cr_assert_not_null(watch, "Cannot start watcher");
+
+    cr_assert(Clipboard_watch_fire(watch), "Cannot fire update");
+    cr_assert(Clipboard_watch_wait(watch, &seen, 1000), "Should be notified about update");
+
+    Clipboard_watch_stop(watch);
+
+    cr_assert_eq(watch_callback_updates, 1, "Callback should be invoked");
+}
+
+typedef struct {
+    Clipboard_watch *watch;
+    bool notified;
+} waiter_ctx;
+
+static DWORD WINAPI waiter(LPVOID param) {
+    waiter_ctx *ctx = (waiter_ctx*)param;
+    size_t seen = 0;
+
+    ctx->notified = Clipboard_watch_wait(ctx->watch, &seen, 1000);
+    return 0;
+}
+
+/**
+ * Test that single notification wakes up every waiting thread.
+ */
+Test(clipboard_watch, multiple_waiters) {
+    Clipboard_watch *watch = Clipboard_watch_start(NULL, NULL, 0);
+    waiter_ctx ctx[2];
+    HANDLE threads[2];
+
+    cr_assert_not_null(watch, "Cannot start watcher");
+
+    for (size_t idx = 0; idx < 2; idx++) {
+        ctx[idx].watch = watch;
+        ctx[idx].notified = false;
+        threads[idx] = CreateThread(NULL, 0, waiter, &ctx[idx], 0, NULL);
+        cr_assert_neq(threads[idx], NULL, "Cannot start waiter");
+    }
+
+    cr_assert(Clipboard_watch_fire(watch), "Cannot fire update");
+
+    for (size_t idx = 0; idx < 2; idx++) {
+        WaitForSingleObject(threads[idx], INFINITE);
+        CloseHandle(threads[idx]);
+        cr_assert(ctx[idx].notified, "Every waiter should be notified");
+    }
+
+    cr_assert_eq(Clipboard_watch_get_stats(watch).notifications, 1);
+
+    Clipboard_watch_stop(watch);
+}
@@ -0,0 +1,236 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+static void write_u32(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * Writes header of bitmap.
+ */
+static void write_header(uint8_t *dst, uint32_t header_size, int32_t width, int32_t height, uint16_t bit_count, uint32_t compression) {
+    memset(dst, 0, header_size);
+    write_u32(dst, header_size);
+    write_u32(dst + 4, (uint32_t)width);
+    write_u32(dst + 8, (uint32_t)height);
+    dst[12] = 1;
+    dst[14] = (uint8_t)bit_count;
+    write_u32(dst + 16, compression);
+}
+
+/**
+ * Test conversion of bottom-up BGR bitmap with row padding.
+ */
+Test(dib, bgr_bottom_up) {
+    /* 2x2 pixels, 6 bytes per row padded to 8. */
+    uint8_t data[40 + 16];
+    const uint8_t pixels[] = {3, 2, 1, 6, 5, 4, 0, 0, 9, 8, 7, 12, 11, 10, 0, 0};
+    const uint8_t expected[] = {
+        7, 8, 9, 0xFF, 10, 11, 12, 0xFF,
+        1, 2, 3, 0xFF, 4, 5, 6, 0xFF
+    };
+    uint8_t rgba[16];
+    Dib_info info;
+
+    write_header(data, 40, 2, 2, 24, 0);
+    memcpy(data + 40, pixels, sizeof(pixels));
+
+    cr_assert(Dib_parse(data, sizeof(data), &info));
+    cr_assert_eq(info.width, 2);
+    cr_assert_eq(info.height, 2);
+    cr_assert_not(info.top_down);
+    cr_assert_eq(info.stride, 8);
+    cr_assert_eq(info.pixels_offset, 40);
+
+    Dib_to_rgba(&info, data, rgba);
+    cr_assert_arr_eq(rgba, expected, sizeof(expected));
+}
+
+/**
+ * Test conversion of top-down BITMAPV5HEADER bitmap with alpha.
+ */
+Test(dib, v5_alpha_top_down) {
+    /* Row is long enough to go through vectorized path. */
+    uint8_t data[124 + 37 * 4];
+    uint8_t rgba[37 * 4];
+    Dib_info info;
+
+    write_header(data, 124, 37, -1, 32, 3);
+    write_u32(data + 40, 0x00FF0000);
+    write_u32(data + 44, 0x0000FF00);
+    write_u32(data + 48, 0x000000FF);
+    write_u32(data + 52, 0xFF000000);
+    for (size_t idx = 0; idx < 37 * 4; idx++) data[124 + idx] = (uint8_t)idx;
+
+    cr_assert(Dib_parse(data, sizeof(data), &info));
+    cr_assert(info.top_down);
+    cr_assert_eq(info.masks[3], 0xFF000000);
+
+    Dib_to_rgba(&info, data, rgba);
+    for (size_t idx = 0; idx < 37; idx++) {
+        cr_assert_eq(rgba[idx * 4], data[124 + idx * 4 + 2]);
+        cr_assert_eq(rgba[idx * 4 + 1], data[124 + idx * 4 + 1]);
+        cr_assert_eq(rgba[idx * 4 + 2], data[124 + idx * 4]);
+        cr_assert_eq(rgba[idx * 4 + 3], data[124 + idx * 4 + 3], "Alpha should be kept");
+    }
+}
+
+/**
+ * Test conversion of 16 bits bitmap with masks that follow header.
+ */
+Test(dib, bitfields_565) {
+    uint8_t data[40 + 12 + 4];
+    uint8_t rgba[4];
+    Dib_info info;
+
+    write_header(data, 40, 1, 1, 16, 3);
+    write_u32(data + 40, 0xF800);
+    write_u32(data + 44, 0x07E0);
+    write_u32(data + 48, 0x001F);
+    /* Pure red. */
+    write_u32(data + 52, 0xF800);
+
+    cr_assert(Dib_parse(data, sizeof(data), &info));
+    cr_assert_eq(info.pixels_offset, 52);
+
+    Dib_to_rgba(&info, data, rgba);
+    cr_assert_eq(rgba[0], 0xFF);
+    cr_assert_eq(rgba[1], 0);
+    cr_assert_eq(rgba[2], 0);
+    cr_assert_eq(rgba[3], 0xFF);
+}
+
+/**
+ * Test rejection of malformed and unsupported bitmaps.
+ */
+Test(dib, malformed) {
+    uint8_t data[40 + 16];
+    Dib_info info;
+
+    write_header(data, 40, 2, 2, 24, 0);
+    cr_assert_not(Dib_parse(data, sizeof(data) - 1, &info), "Pixels don't fit");
+
+    write_header(data, 40, 2, 2, 8, 0);
+    cr_assert_not(Dib_parse(data, sizeof(data), &info), "Palette bitmaps are unsupported");
+
+    write_header(data, 40, 0, 2, 24, 0);
+    cr_assert_not(Dib_parse(data, sizeof(data), &info), "Width must be positive");
+
+    write_header(data, 40, 1, 1, 32, 3);
+    write_u32(data + 40, 0x00FF00FF);
+    cr_assert_not(Dib_parse(data, sizeof(data), &info), "Masks must be contiguous");
+}
+
+/**
+ * Test BI_ALPHABITFIELDS header that holds only red, green and blue masks.
+ */
+Test(dib, alphabitfields_short_header) {
+    uint8_t data[52 + 4 + 4];
+    uint8_t rgba[4];
+    Dib_info info;
+
+    write_header(data, 52, 1, 1, 32, 6);
+    write_u32(data + 40, 0x00FF0000);
+    write_u32(data + 44, 0x0000FF00);
+    write_u32(data + 48, 0x000000FF);
+    cr_assert_not(Dib_parse(data, 52, &info), "Alpha mask doesn't fit");
+
+    write_u32(data + 52, 0xFF000000);
+    write_u32(data + 56, 0x80010203);
+
+    cr_assert(Dib_parse(data, sizeof(data), &info));
+    cr_assert_eq(info.masks[3], 0xFF000000);
+    cr_assert_eq(info.pixels_offset, 56);
+
+    Dib_to_rgba(&info, data, rgba);
+    cr_assert_eq(rgba[0], 0x01);
+    cr_assert_eq(rgba[1], 0x02);
+    cr_assert_eq(rgba[2], 0x03);
+    cr_assert_eq(rgba[3], 0x80);
+}
+
+#define BENCH_WIDTH 3840
+#define BENCH_HEIGHT 2160
+#define BENCH_ROUNDS 10
+#define BENCH_HEADER 40
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Flips bottom-up BGR(A) rows into top-down RGBA byte by byte.
+ */
+static void naive_to_rgba(const uint8_t *pixels, size_t stride, size_t bytes_per_pixel, uint8_t *rgba) {
+    for (size_t row = 0; row < BENCH_HEIGHT; row++) {
+        const uint8_t *src = pixels + (BENCH_HEIGHT - 1 - row) * stride;
+
+        for (size_t col = 0; col < BENCH_WIDTH; col++, src += bytes_per_pixel, rgba += 4) {
+            rgba[0] = src[2];
+            rgba[1] = src[1];
+            rgba[2] = src[0];
+            rgba[3] = bytes_per_pixel == 4 ? src[3] : 0xFF;
+        }
+    }
+}
+
+/**
+ * Measures conversion of 4K bitmap against naive loop.
+ */
+static void bench_convert(uint16_t bit_count) {
+    const size_t bytes_per_pixel = bit_count / 8;
+    const size_t stride = (BENCH_WIDTH * bytes_per_pixel + 3) / 4 * 4;
+    const size_t size = BENCH_HEADER + stride * BENCH_HEIGHT;
+    uint8_t *data = (uint8_t*)malloc(size);
+    uint8_t *rgba = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+    uint8_t *expected = (uint8_t*)malloc(BENCH_WIDTH * BENCH_HEIGHT * 4);
+    Dib_info info;
+
+    cr_assert_not_null(data);
+    cr_assert_not_null(rgba);
+    cr_assert_not_null(expected);
+
+    write_header(data, BENCH_HEADER, BENCH_WIDTH, BENCH_HEIGHT, bit_count, 0);
+    for (size_t idx = BENCH_HEADER; idx < size; idx++) data[idx] = (uint8_t)(idx * 7);
+    cr_assert(Dib_parse(data, size, &info));
+
+    const double naive_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) naive_to_rgba(data + BENCH_HEADER, stride, bytes_per_pixel, expected);
+    const double naive_time = bench_now() - naive_start;
+
+    const double dib_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) Dib_to_rgba(&info, data, rgba);
+    const double dib_time = bench_now() - dib_start;
+
+    /* BI_RGB with 32 bits has no alpha, so Dib makes pixels opaque. */
+    if (bytes_per_pixel == 4) {
+        for (size_t idx = 3; idx < BENCH_WIDTH * BENCH_HEIGHT * 4; idx += 4) expected[idx] = 0xFF;
+    }
+    cr_assert_arr_eq(rgba, expected, BENCH_WIDTH * BENCH_HEIGHT * 4);
+
+    cr_log_info("%u bits: Dib_to_rgba %.2f ms, naive loop %.2f ms", (unsigned)bit_count,
+                dib_time * 1e3 / BENCH_ROUNDS, naive_time * 1e3 / BENCH_ROUNDS);
+
+    free(data);
+    free(rgba);
+    free(expected);
+}
+
+/**
+ * Measures conversion of 4K bitmaps.
+ */
+Test(dib, bench_convert) {
+    bench_convert(24);
+    bench_convert(32);
+}
@@ -0,0 +1,82 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+/**
+ * Test iteration over ANSI list.
+ */
+Test(drop, ansi) {
+    /* Header: pFiles = 20, pt = (0, 0), fNC = 0, fWide = 0. */
+    const uint8_t data[] = {
+        20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        'C', ':', '\\', 'a', 0, 'b', 0, 0
+    };
+    Drop_iter iter;
+    Drop_path path;
+
+    cr_assert(Drop_iter_init(&iter, data, sizeof(data)));
+
+    cr_assert(Drop_iter_next(&iter, &path));
+    cr_assert_null(path.wide);
+    cr_assert_eq(path.len, 4);
+    cr_assert_arr_eq(path.ansi, "C:\\a", 4);
+
+    cr_assert(Drop_iter_next(&iter, &path));
+    cr_assert_eq(path.len, 1);
+    cr_assert_eq(path.ansi, (const char*)data + 25, "Path should point into parsed memory");
+
+    cr_assert_not(Drop_iter_next(&iter, &path), "List ends with empty path");
+}
+
+/**
+ * Test iteration over wide list.
+ */
+Test(drop, wide) {
+    uint16_t data[16] = {0};
+    Drop_iter iter;
+    Drop_path path;
+
+    /* pFiles = 20, fWide = 1. */
+    data[0] = 20;
+    data[8] = 1;
+    data[10] = 0x44F;
+    data[11] = 'a';
+    data[13] = 'b';
+
+    cr_assert(Drop_iter_init(&iter, (const uint8_t*)data, sizeof(data)));
+
+    cr_assert(Drop_iter_next(&iter, &path));
+    cr_assert_null(path.ansi);
+    cr_assert_eq(path.len, 2);
+    cr_assert_eq(path.wide, data + 10);
+
+    cr_assert(Drop_iter_next(&iter, &path));
+    cr_assert_eq(path.len, 1);
+    cr_assert_eq(path.wide[0], 'b');
+
+    cr_assert_not(Drop_iter_next(&iter, &path));
+}
+
+/**
+ * Test rejection of malformed lists.
+ */
+Test(drop, malformed) {
+    uint8_t data[24] = {20};
+    Drop_iter iter;
+    Drop_path path;
+
+    cr_assert_not(Drop_iter_init(&iter, data, 19), "Header doesn't fit");
+
+    data[0] = 25;
+    cr_assert_not(Drop_iter_init(&iter, data, sizeof(data)), "Paths are past end");
+
+    data[0] = 21;
+    data[16] = 1;
+    cr_assert_not(Drop_iter_init(&iter, data, sizeof(data)), "Wide paths are not aligned");
+
+    data[0] = 20;
+    data[16] = 0;
+    memcpy(data + 20, "abcd", 4);
+    cr_assert(Drop_iter_init(&iter, data, sizeof(data)));
+    cr_assert_not(Drop_iter_next(&iter, &path), "Path without null char should not be yielded");
+}
@@ -0,0 +1,83 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+/**
+ * Test compression of repetitive data and its decompression.
+ */
+Test(lz, round_trip) {
+    uint8_t data[4096];
+    uint8_t packed[4096];
+    uint8_t unpacked[4096];
+
+    for (size_t idx = 0; idx < sizeof(data); idx++) data[idx] = (uint8_t)("For my waifu!"[idx % 13] + idx / 1000);
+
+    const size_t packed_size = Lz_compress(data, sizeof(data), packed, sizeof(packed));
+    cr_assert_neq(packed_size, 0, "Compression failed");
+    cr_assert_lt(packed_size, sizeof(data) / 8, "Repetitive data should compress well");
+
+    cr_assert_eq(Lz_decompress(packed, packed_size, unpacked, sizeof(unpacked)), sizeof(data));
+    cr_assert_arr_eq(unpacked, data, sizeof(data));
+
+    cr_assert_eq(Lz_decompress(packed, packed_size, unpacked, 100), 100, "Prefix should be extracted");
+    cr_assert_arr_eq(unpacked, data, 100);
+}
+
+/**
+ * Test that data which doesn't compress fits into bound.
+ */
+Test(lz, incompressible) {
+    uint8_t data[1024];
+    uint8_t packed[1024 + 32];
+    uint8_t unpacked[1024];
+    uint32_t state = 1;
+
+    for (size_t idx = 0; idx < sizeof(data); idx++) {
+        state = state * 1103515245 + 12345;
+        data[idx] = (uint8_t)(state >> 24);
+    }
+
+    cr_assert_leq(Lz_compress_bound(sizeof(data)), sizeof(packed));
+    cr_assert_eq(Lz_compress(data, sizeof(data), packed, sizeof(data) / 2), 0, "Output should not fit");
+
+    const size_t packed_size = Lz_compress(data, sizeof(data), packed, sizeof(packed));
+    cr_assert_neq(packed_size, 0, "Compression failed");
+    cr_assert_eq(Lz_decompress(packed, packed_size, unpacked, sizeof(unpacked)), sizeof(data));
+    cr_assert_arr_eq(unpacked, data, sizeof(data));
+}
+
+/**
+ * Test rejection of malformed data.
+ */
+Test(lz, malformed) {
+    /* Match refers before start of data. */
+    const uint8_t bad_offset[] = {0x10, 'a', 0x02, 0x00};
+    /* Literals go past end of data. */
+    const uint8_t bad_literals[] = {0x50, 'a', 'b'};
+    uint8_t unpacked[16];
+
+    cr_assert_eq(Lz_decompress(bad_offset, sizeof(bad_offset), unpacked, sizeof(unpacked)), 0);
+    cr_assert_eq(Lz_decompress(bad_literals, sizeof(bad_literals), unpacked, sizeof(unpacked)), 0);
+}
+
+/**
+ * Test that decompressed data fits into bound.
+ */
+Test(lz, decompress_bound) {
+    /* Literal followed by match that repeats it with longest length continuation. */
+    uint8_t packed[3 + 2 + 64];
+    uint8_t unpacked[1 + 4 + 15 + 64 * 255 + 254];
+
+    packed[0] = 0x1F;
+    packed[1] = 'a';
+    packed[2] = 0x01;
+    packed[3] = 0x00;
+    memset(packed + 4, 255, sizeof(packed) - 5);
+    packed[sizeof(packed) - 1] = 254;
+
+    const size_t unpacked_size = Lz_decompress(packed, sizeof(packed), unpacked, sizeof(unpacked));
+
+    cr_assert_eq(unpacked_size, sizeof(unpacked));
+    cr_assert_leq(unpacked_size, Lz_decompress_bound(sizeof(packed)));
+    cr_assert_eq(Lz_decompress_bound(SIZE_MAX), SIZE_MAX, "Bound should saturate");
+}
@@ -0,0 +1,141 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+/**
+ * Test compilation of text patterns.
+ */
+Test(pattern, compile) {
+    Pattern pattern;
+
+    cr_assert(Pattern_compile(&pattern, "48 8b ?? ? 05\tE8  "));
+    cr_assert_eq(pattern.len, 6);
+    cr_assert_eq(pattern.bytes[1], 0x8B);
+    cr_assert_eq(pattern.mask[2], 0);
+    cr_assert_eq(pattern.mask[3], 0);
+    cr_assert_eq(pattern.mask[5], 0xFF);
+
+    cr_assert_not(Pattern_compile(&pattern, ""));
+    cr_assert_not(Pattern_compile(&pattern, "4"));
+    cr_assert_not(Pattern_compile(&pattern, "48x"));
+    cr_assert_not(Pattern_compile(&pattern, "???"));
+    cr_assert_not(Pattern_compile(&pattern, "4 8"));
+}
+
+/**
+ * Test search with wildcards at every position of buffer.
+ */
+Test(pattern, find) {
+    Pattern pattern;
+    uint8_t data[200] = {0};
+
+    cr_assert(Pattern_compile(&pattern, "E8 ?? ?? 00 00 C3"));
+
+    for (size_t pos = 0; pos + pattern.len <= sizeof(data); pos++) {
+        memset(data, 0, sizeof(data));
+        /* Partial matches before the real one. */
+        if (pos >= 8) memcpy(data + pos - 8, "\xE8\x01\x02\x00\x01\xC3", 6);
+
+        memcpy(data + pos, "\xE8\x11\x22\x00\x00\xC3", 6);
+
+        cr_assert_eq(Pattern_find(&pattern, data, sizeof(data)), data + pos);
+        cr_assert_null(Pattern_find(&pattern, data + pos + 1, sizeof(data) - pos - 1));
+    }
+
+    cr_assert_null(Pattern_find(&pattern, data, 5), "Pattern should not fit");
+}
+
+/**
+ * Test patterns from bytes, including one that has no fixed bytes.
+ */
+Test(pattern, from_bytes) {
+    Pattern pattern;
+    const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    const uint8_t bytes[] = {4, 0, 6};
+    const uint8_t mask[] = {1, 0, 1};
+    const uint8_t wildcards[] = {0, 0};
+
+    cr_assert(Pattern_from_bytes(&pattern, bytes, mask, sizeof(bytes)));
+    cr_assert_eq(Pattern_find(&pattern, data, sizeof(data)), data + 3);
+
+    cr_assert(Pattern_from_bytes(&pattern, bytes, NULL, sizeof(bytes)));
+    cr_assert_null(Pattern_find(&pattern, data, sizeof(data)));
+
+    cr_assert(Pattern_from_bytes(&pattern, bytes, wildcards, sizeof(wildcards)));
+    cr_assert_eq(Pattern_find(&pattern, data, sizeof(data)), data);
+
+    cr_assert_not(Pattern_from_bytes(&pattern, bytes, NULL, 0));
+    cr_assert_not(Pattern_from_bytes(&pattern, bytes, NULL, PATTERN_MAX_LEN + 1));
+}
+
+#define BENCH_SIZE (64 * 1024 * 1024)
+#define BENCH_ROUNDS 4
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Finds the first match by comparing pattern at every position.
+ */
+static const uint8_t* naive_find(const Pattern *pattern, const uint8_t *data, size_t size) {
+    for (size_t pos = 0; pos + pattern->len <= size; pos++) {
+        size_t idx = 0;
+
+        while (idx < pattern->len && (data[pos + idx] & pattern->mask[idx]) == pattern->bytes[idx]) idx++;
+        if (idx == pattern->len) return data + pos;
+    }
+
+    return NULL;
+}
+
+/**
+ * Measures search in memory that looks like code against naive loop.
+ */
+Test(pattern, bench_find) {
+    const char signature[] = "\x48\x8B\x05\x11\x22\x33\x44\xE8";
+    uint8_t *data = (uint8_t*)malloc(BENCH_SIZE);
+    uint32_t seed = 1;
+    Pattern pattern;
+
+    cr_assert_not_null(data);
+
+    /* Bytes are skewed towards zero and common opcodes, as in code. */
+    for (size_t idx = 0; idx < BENCH_SIZE; idx++) {
+        seed = seed * 1103515245 + 12345;
+
+        const uint32_t value = seed >> 16;
+        data[idx] = (value & 3) == 0 ? 0 : (value & 7) == 1 ? 0x48 : (value & 15) == 3 ? 0x8B : (uint8_t)(value >> 8);
+        /* The only match is the one placed at the end. */
+        if (data[idx] == 0xE8) data[idx] = 0xE9;
+    }
+    memcpy(data + BENCH_SIZE - sizeof(signature), signature, sizeof(signature) - 1);
+
+    cr_assert(Pattern_compile(&pattern, "48 8B 05 ?? ?? ?? ?? E8"));
+    cr_assert_eq(naive_find(&pattern, data, BENCH_SIZE), data + BENCH_SIZE - sizeof(signature));
+
+    const double naive_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(naive_find(&pattern, data, BENCH_SIZE), data + BENCH_SIZE - sizeof(signature));
+    }
+    const double naive_time = bench_now() - naive_start;
+
+    const double find_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(Pattern_find(&pattern, data, BENCH_SIZE), data + BENCH_SIZE - sizeof(signature));
+    }
+    const double find_time = bench_now() - find_start;
+
+    cr_log_info("Pattern_find %.0f MB/s, naive loop %.0f MB/s",
+                (double)BENCH_SIZE * BENCH_ROUNDS / find_time / 1e6,
+                (double)BENCH_SIZE * BENCH_ROUNDS / naive_time / 1e6);
+
+    free(data);
+}
@@ -11,3 +11,130 @@ Test(process, get_exe) {
 
     cr_assert_not_null(wcsstr(buffer, binary_name), "Couldn't locate own exe name");
 }
+
+/**
+ * Test batched read of regions that are merged, out of order and invalid.
+ */
+Test(process, read_mem_batch) {
+    uint8_t memory[1024];
+    uint8_t buffers[5][64] = {{0}};
+    bool result[5] = {0};
+
+    for (size_t idx = 0; idx < sizeof(memory); idx++) memory[idx] = (uint8_t)(idx * 7);
+
+    const uintptr_t base = (uintptr_t)memory;
+    const Process_iovec remote[5] = {
+        {base + 512, buffers[0], 64},
+        {base, buffers[1], 32},
+        {base + 16, buffers[2], 32},
+        {0, buffers[3], 16},
+        {base + 32, buffers[4], 64},
+    };
+
+    cr_assert_eq(Process_read_mem_batch(Process_self(), remote, 5, result), 4);
+
+    cr_assert(result[0]);
+    cr_assert(result[1]);
+    cr_assert(result[2]);
+    cr_assert_not(result[3], "Null address should not be readable");
+    cr_assert(result[4]);
+
+    cr_assert_arr_eq(buffers[0], memory + 512, 64);
+    cr_assert_arr_eq(buffers[1], memory, 32);
+    cr_assert_arr_eq(buffers[2], memory + 16, 32);
+    cr_assert_arr_eq(buffers[4], memory + 32, 64);
+}
+
+/**
+ * Test that failure of merged read affects only regions that cannot be read.
+ */
+Test(process, read_mem_batch_partial) {
+    SYSTEM_INFO info;
+    DWORD old_protect;
+    uint8_t buffers[2][16] = {{0}};
+    bool result[2] = {0};
+
+    GetSystemInfo(&info);
+
+    uint8_t *pages = (uint8_t*)VirtualAlloc(NULL, info.dwPageSize * 2, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    cr_assert_not_null(pages);
+    memset(pages, 0xAB, info.dwPageSize);
+    cr_assert(VirtualProtect(pages + info.dwPageSize, info.dwPageSize, PAGE_NOACCESS, &old_protect));
+
+    const uintptr_t boundary = (uintptr_t)pages + info.dwPageSize;
+    const Process_iovec remote[2] = {
+        {boundary - 16, buffers[0], 16},
+        {boundary, buffers[1], 16},
+    };
+
+    cr_assert_eq(Process_read_mem_batch(Process_self(), remote, 2, result), 1);
+    cr_assert(result[0]);
+    cr_assert_not(result[1]);
+    cr_assert_arr_eq(buffers[0], pages + info.dwPageSize - 16, 16);
+
+    cr_assert(VirtualFree(pages, 0, MEM_RELEASE));
+}
+
+/**
+ * Finds region of own process that contains address.
+ */
+static bool find_region(unsigned flags, uintptr_t address, Process_region *region) {
+    Process_region_iter iter;
+
+    Process_region_iter_init(&iter, Process_self(), flags);
+
+    while (Process_region_iter_next(&iter, region)) {
+        if (address >= region->base && address - region->base < region->size) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Test filters and coalescing of regions.
+ */
+Test(process, region_iter) {
+    SYSTEM_INFO info;
+    DWORD old_protect;
+    Process_region region;
+
+    GetSystemInfo(&info);
+
+    const size_t page = info.dwPageSize;
+    uint8_t *pages = (uint8_t*)VirtualAlloc(NULL, page * 3, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    const uintptr_t base = (uintptr_t)pages;
+    cr_assert_not_null(pages);
+
+    cr_assert(find_region(PROCESS_REGION_COMMITTED | PROCESS_REGION_PRIVATE | PROCESS_REGION_COALESCE, base, &region));
+    cr_assert_leq(region.base, base);
+    cr_assert_geq(region.base + region.size, base + page * 3, "Pages should be coalesced");
+    cr_assert_eq(region.state, MEM_COMMIT);
+    cr_assert_eq(region.protect, PAGE_READWRITE);
+    cr_assert_eq(region.type, MEM_PRIVATE);
+
+    cr_assert_not(find_region(PROCESS_REGION_IMAGE | PROCESS_REGION_MAPPED, base, &region), "Private region should be filtered out");
+
+    cr_assert(VirtualProtect(pages + page, page, PAGE_NOACCESS, &old_protect));
+
+    cr_assert(find_region(PROCESS_REGION_COMMITTED | PROCESS_REGION_COALESCE, base + page, &region));
+    cr_assert_eq(region.base, base + page);
+    cr_assert_eq(region.size, page);
+    cr_assert_eq(region.protect, PAGE_NOACCESS);
+
+    cr_assert_not(find_region(PROCESS_REGION_READABLE | PROCESS_REGION_COALESCE, base + page, &region));
+    cr_assert(find_region(PROCESS_REGION_READABLE | PROCESS_REGION_COALESCE, base + page * 2, &region));
+    cr_assert_eq(region.base, base + page * 2);
+
+    cr_assert(VirtualFree(pages, 0, MEM_RELEASE));
+}
+
+/**
+ * Test that image of own executable is found with its file.
+ */
+Test(process, region_iter_image) {
+    Process_region region;
+
+    cr_assert(find_region(PROCESS_REGION_IMAGE | PROCESS_REGION_FILE, (uintptr_t)&find_region, &region));
+    cr_assert_eq(region.type, MEM_IMAGE);
+    cr_assert_not_null(wcsstr(region.file, L"ut.exe"), "Couldn't locate own exe name");
+}
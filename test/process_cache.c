@@ -0,0 +1,123 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+static uint8_t *pages = NULL;
+static SYSTEM_INFO info;
+
+#define PAGES 8
+
+static void setup() {
+    GetSystemInfo(&info);
+
+    pages = (uint8_t*)VirtualAlloc(NULL, PAGES * PROCESS_CACHE_PAGE_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    cr_assert_not_null(pages);
+
+    for (size_t idx = 0; idx < PAGES * PROCESS_CACHE_PAGE_SIZE; idx++) pages[idx] = (uint8_t)(idx * 13);
+}
+
+static void teardown() {
+    VirtualFree(pages, 0, MEM_RELEASE);
+}
+
+TestSuite(process_cache, .init = setup, .fini = teardown);
+
+/**
+ * Test hits, misses and invalidation.
+ */
+Test(process_cache, read) {
+    Process_cache cache;
+    uint8_t buffer[PROCESS_CACHE_PAGE_SIZE * 2];
+    const uintptr_t base = (uintptr_t)pages + 100;
+    const size_t size = PROCESS_CACHE_PAGE_SIZE + 200;
+
+    cr_assert(Process_cache_init(&cache, PAGES * PROCESS_CACHE_PAGE_SIZE));
+
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), base, buffer, size), buffer);
+    cr_assert_arr_eq(buffer, pages + 100, size);
+
+    Process_cache_stats stats = Process_cache_get_stats(&cache);
+    cr_assert_eq(stats.misses, 2);
+    cr_assert_eq(stats.hits, 0);
+    cr_assert_eq(stats.reads, 1, "Missing pages should be read at once");
+
+    /* Cached content is returned until invalidated. */
+    pages[100] ^= 0xFF;
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), base, buffer, 16), buffer);
+    cr_assert_neq(buffer[0], pages[100]);
+
+    stats = Process_cache_get_stats(&cache);
+    cr_assert_eq(stats.hits, 1);
+    cr_assert_eq(stats.bytes_saved, 16);
+
+    Process_cache_invalidate_range(&cache, Process_self(), base, 1);
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), base, buffer, 16), buffer);
+    cr_assert_eq(buffer[0], pages[100]);
+
+    pages[100] ^= 0xFF;
+    Process_cache_next_generation(&cache);
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), base, buffer, 16), buffer);
+    cr_assert_eq(buffer[0], pages[100]);
+
+    pages[100] ^= 0xFF;
+    Process_cache_invalidate(&cache);
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), base, buffer, 16), buffer);
+    cr_assert_eq(buffer[0], pages[100]);
+
+    stats = Process_cache_get_stats(&cache);
+    cr_assert_eq(stats.misses, 5);
+    cr_assert_eq(stats.hits, 1);
+
+    Process_cache_free(&cache);
+}
+
+/**
+ * Test that prefetch and reads bigger than budget evict pages.
+ */
+Test(process_cache, budget) {
+    Process_cache cache;
+    uint8_t buffer[PAGES * PROCESS_CACHE_PAGE_SIZE];
+
+    cr_assert(Process_cache_init(&cache, 2 * PROCESS_CACHE_PAGE_SIZE));
+
+    cr_assert(Process_cache_prefetch(&cache, Process_self(), (uintptr_t)pages, 2 * PROCESS_CACHE_PAGE_SIZE));
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), (uintptr_t)pages, buffer, 2 * PROCESS_CACHE_PAGE_SIZE), buffer);
+
+    Process_cache_stats stats = Process_cache_get_stats(&cache);
+    cr_assert_eq(stats.misses, 2);
+    cr_assert_eq(stats.hits, 2);
+    cr_assert_eq(stats.reads, 1);
+
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), (uintptr_t)pages, buffer, sizeof(buffer)), buffer);
+    cr_assert_arr_eq(buffer, pages, sizeof(buffer));
+
+    stats = Process_cache_get_stats(&cache);
+    cr_assert_eq(stats.evictions, PAGES - 2);
+
+    Process_cache_free(&cache);
+}
+
+/**
+ * Test that unreadable pages are not cached.
+ */
+Test(process_cache, unreadable) {
+    Process_cache cache;
+    DWORD old_protect;
+    uint8_t buffer[32];
+    const uintptr_t boundary = (uintptr_t)pages + PROCESS_CACHE_PAGE_SIZE;
+
+    cr_assert(VirtualProtect(pages + PROCESS_CACHE_PAGE_SIZE, PROCESS_CACHE_PAGE_SIZE, PAGE_NOACCESS, &old_protect));
+    cr_assert(Process_cache_init(&cache, PAGES * PROCESS_CACHE_PAGE_SIZE));
+
+    cr_assert_null(Process_cache_read(&cache, Process_self(), boundary - 16, buffer, sizeof(buffer)));
+    cr_assert_not(Process_cache_prefetch(&cache, Process_self(), boundary - 16, sizeof(buffer)));
+
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), boundary - 16, buffer, 16), buffer);
+    cr_assert_arr_eq(buffer, pages + PROCESS_CACHE_PAGE_SIZE - 16, 16);
+
+    cr_assert(VirtualProtect(pages + PROCESS_CACHE_PAGE_SIZE, PROCESS_CACHE_PAGE_SIZE, PAGE_READWRITE, &old_protect));
+    cr_assert_eq(Process_cache_read(&cache, Process_self(), boundary - 16, buffer, sizeof(buffer)), buffer);
+    cr_assert_arr_eq(buffer, pages + PROCESS_CACHE_PAGE_SIZE - 16, sizeof(buffer));
+
+    Process_cache_free(&cache);
+}
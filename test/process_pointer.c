@@ -0,0 +1,163 @@
+#include <criterion/criterion.h>
+#include <stddef.h>
+
+#include "lazy_winapi.h"
+
+typedef struct node {
+    struct node *next;
+    struct node *other;
+    uintptr_t value;
+} node;
+
+static node nodes[3];
+static node *root = &nodes[0];
+
+/**
+ * Test paths that share prefix and paths that fail.
+ */
+Test(process_pointer, resolve) {
+    const intptr_t value_offsets[] = {0, offsetof(node, next), offsetof(node, value)};
+    const intptr_t next_offsets[] = {0, offsetof(node, next), offsetof(node, next), offsetof(node, value)};
+    const intptr_t null_offsets[] = {0, offsetof(node, other), 0};
+    const intptr_t bad_offsets[] = {0, offsetof(node, value), 0, 0};
+    const Process_pointer_path paths[] = {
+        {(uintptr_t)&root, value_offsets, 3},
+        {(uintptr_t)&root, next_offsets, 4},
+        {(uintptr_t)&root, null_offsets, 3},
+        {(uintptr_t)&root, bad_offsets, 4},
+        {(uintptr_t)&root, NULL, 0}
+    };
+    Process_pointer_result results[5];
+    Process_pointer_resolver resolver;
+
+    memset(nodes, 0, sizeof(nodes));
+    nodes[0].next = &nodes[1];
+    nodes[0].value = 16;
+    nodes[1].next = &nodes[2];
+
+    cr_assert(Process_pointer_init(&resolver, Process_self(), 0));
+
+    cr_assert_eq(Process_pointer_resolve(&resolver, paths, 5, results), 3);
+
+    cr_assert_eq(results[0].address, (uintptr_t)&nodes[1].value);
+    cr_assert_eq(results[0].depth, 2);
+    cr_assert_eq(results[1].address, (uintptr_t)&nodes[2].value);
+    cr_assert_eq(results[1].depth, 3);
+    cr_assert_eq(results[2].address, 0);
+    cr_assert_eq(results[2].depth, 1, "NULL pointer is at depth 1");
+    cr_assert_eq(results[3].address, 0);
+    cr_assert_eq(results[3].depth, 2, "Pointer at address 16 cannot be read");
+    cr_assert_eq(results[4].address, (uintptr_t)&root);
+    cr_assert_eq(results[4].depth, 0);
+
+    nodes[0].next = &nodes[2];
+
+    cr_assert_eq(Process_pointer_resolve(&resolver, paths, 1, results), 1);
+    cr_assert_eq(results[0].address, (uintptr_t)&nodes[1].value, "Pointers are remembered within tick");
+
+    Process_pointer_next_tick(&resolver);
+
+    cr_assert_eq(Process_pointer_resolve(&resolver, paths, 1, results), 1);
+    cr_assert_eq(results[0].address, (uintptr_t)&nodes[2].value);
+
+    Process_pointer_free(&resolver);
+
+    cr_assert_not(Process_pointer_init(&resolver, Process_self(), 3));
+}
+
+#define BENCH_PATHS 256
+#define BENCH_LEN 6
+#define BENCH_TICKS 200
+
+static node *bench_root;
+static node bench_shared[2];
+static node *bench_hub[BENCH_PATHS];
+static node bench_leaves[BENCH_PATHS][2];
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Resolves path by reading each pointer on its own.
+ *
+ * @return Resolved address or 0.
+ */
+static uintptr_t naive_resolve(const Process_pointer_path *path, size_t *reads) {
+    uintptr_t address = path->base + (uintptr_t)path->offsets[0];
+
+    for (size_t idx = 1; idx < path->len; idx++) {
+        uintptr_t pointer = 0;
+
+        (*reads)++;
+        if (Process_read_mem(Process_self(), address, (uint8_t*)&pointer, sizeof(pointer)) == NULL || pointer == 0) return 0;
+        address = pointer + (uintptr_t)path->offsets[idx];
+    }
+
+    return address;
+}
+
+/**
+ * Compares resolver with loop that reads each pointer of each path.
+ *
+ * Paths share prefix of 3 pointers and then go through their own 2 pointers.
+ */
+Test(process_pointer, bench_against_naive) {
+    static intptr_t offsets[BENCH_PATHS][BENCH_LEN];
+    static Process_pointer_path paths[BENCH_PATHS];
+    static Process_pointer_result results[BENCH_PATHS];
+    Process_pointer_resolver resolver;
+    size_t naive_reads = 0;
+
+    bench_root = &bench_shared[0];
+    bench_shared[0].next = &bench_shared[1];
+    bench_shared[1].next = (node*)bench_hub;
+    for (size_t idx = 0; idx < BENCH_PATHS; idx++) {
+        bench_hub[idx] = &bench_leaves[idx][0];
+        bench_leaves[idx][0].next = &bench_leaves[idx][1];
+        bench_leaves[idx][1].value = idx;
+
+        offsets[idx][0] = 0;
+        offsets[idx][1] = offsetof(node, next);
+        offsets[idx][2] = offsetof(node, next);
+        offsets[idx][3] = (intptr_t)(idx * sizeof(node*));
+        offsets[idx][4] = offsetof(node, next);
+        offsets[idx][5] = offsetof(node, value);
+        paths[idx] = (Process_pointer_path){(uintptr_t)&bench_root, offsets[idx], BENCH_LEN};
+    }
+
+    const double naive_start = bench_now();
+    for (size_t tick = 0; tick < BENCH_TICKS; tick++) {
+        for (size_t idx = 0; idx < BENCH_PATHS; idx++) {
+            cr_assert_eq(naive_resolve(&paths[idx], &naive_reads), (uintptr_t)&bench_leaves[idx][1].value);
+        }
+    }
+    const double naive_time = bench_now() - naive_start;
+
+    cr_assert(Process_pointer_init(&resolver, Process_self(), 0));
+
+    const double resolver_start = bench_now();
+    for (size_t tick = 0; tick < BENCH_TICKS; tick++) {
+        Process_pointer_next_tick(&resolver);
+        cr_assert_eq(Process_pointer_resolve(&resolver, paths, BENCH_PATHS, results), BENCH_PATHS);
+    }
+    const double resolver_time = bench_now() - resolver_start;
+
+    Process_pointer_free(&resolver);
+
+    for (size_t idx = 0; idx < BENCH_PATHS; idx++) {
+        cr_assert_eq(results[idx].address, (uintptr_t)&bench_leaves[idx][1].value);
+    }
+
+    /* Resolver reads each distinct pointer once per tick, one batch per level. */
+    cr_log_info("naive: %lu reads, %.1f us per tick", (unsigned long)(naive_reads / BENCH_TICKS), naive_time * 1e6 / BENCH_TICKS);
+    cr_log_info("resolver: %d pointers in %d batched reads, %.1f us per tick",
+                3 + BENCH_PATHS * 2, BENCH_LEN - 1, resolver_time * 1e6 / BENCH_TICKS);
+}
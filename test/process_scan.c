@@ -0,0 +1,142 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+#define SIZE (3 * 1024 * 1024)
+
+/**
+ * Test that every match is found once, including ones across chunks, with any number of threads.
+ */
+Test(process_scan, find) {
+    SYSTEM_INFO info;
+    DWORD old_protect;
+    Pattern pattern;
+    uintptr_t matches[8];
+    const uint8_t signature[] = {0xDE, 0xAD, 0x00, 0xEF};
+
+    GetSystemInfo(&info);
+
+    uint8_t *memory = (uint8_t*)VirtualAlloc(NULL, SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    cr_assert_not_null(memory);
+
+    const size_t chunk_size = 64 * 1024;
+    const size_t offsets[] = {0, chunk_size - 2, chunk_size * 5 + 100, SIZE - sizeof(signature)};
+
+    for (size_t idx = 0; idx < sizeof(offsets) / sizeof(offsets[0]); idx++) {
+        memcpy(memory + offsets[idx], signature, sizeof(signature));
+    }
+
+    /* Unreadable page in the middle is skipped. */
+    cr_assert(VirtualProtect(memory + SIZE / 2, info.dwPageSize, PAGE_NOACCESS, &old_protect));
+
+    cr_assert(Pattern_compile(&pattern, "DE AD ?? EF"));
+
+    for (size_t threads = 1; threads <= 4; threads++) {
+        Process_scan_options options = {0};
+
+        options.threads = threads;
+        options.chunk_size = chunk_size;
+        options.start = (uintptr_t)memory;
+        options.end = (uintptr_t)memory + SIZE;
+
+        memset(matches, 0, sizeof(matches));
+        cr_assert_eq(Process_scan(Process_self(), &pattern, &options, matches, 8), 4);
+
+        for (size_t idx = 0; idx < 4; idx++) {
+            cr_assert_eq(matches[idx], (uintptr_t)memory + offsets[idx]);
+        }
+
+        cr_assert_eq(Process_scan(Process_self(), &pattern, &options, matches, 1), 4, "Count should not be limited by results");
+        cr_assert_eq(matches[0], (uintptr_t)memory);
+    }
+
+    cr_assert(VirtualFree(memory, 0, MEM_RELEASE));
+}
+
+#define BENCH_SIZE (64 * 1024 * 1024)
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Counts matches by reading memory in chunks and comparing pattern at every position.
+ */
+static size_t naive_scan(const Pattern *pattern, uintptr_t start, size_t size) {
+    const size_t chunk_size = PROCESS_SCAN_CHUNK_SIZE;
+    uint8_t *buffer = (uint8_t*)malloc(chunk_size + pattern->len - 1);
+    size_t result = 0;
+
+    cr_assert_not_null(buffer);
+
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+        const size_t read_size = size - offset < chunk_size + pattern->len - 1 ? size - offset : chunk_size + pattern->len - 1;
+
+        cr_assert_not_null(Process_read_mem(Process_self(), start + offset, buffer, read_size));
+
+        for (size_t pos = 0; pos + pattern->len <= read_size && pos < chunk_size; pos++) {
+            size_t idx = 0;
+
+            while (idx < pattern->len && (buffer[pos + idx] & pattern->mask[idx]) == pattern->bytes[idx]) idx++;
+            if (idx == pattern->len) result++;
+        }
+    }
+
+    free(buffer);
+    return result;
+}
+
+/**
+ * Measures scan of large heap against single threaded naive loop.
+ */
+Test(process_scan, bench_scan) {
+    const uint8_t signature[] = {0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44, 0xE8};
+    uint8_t *memory = (uint8_t*)VirtualAlloc(NULL, BENCH_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    uint32_t seed = 1;
+    uintptr_t match = 0;
+    Pattern pattern;
+
+    cr_assert_not_null(memory);
+
+    /* Bytes are skewed towards zero and common opcodes, as in code. */
+    for (size_t idx = 0; idx < BENCH_SIZE; idx++) {
+        seed = seed * 1103515245 + 12345;
+
+        const uint32_t value = seed >> 16;
+        memory[idx] = (value & 3) == 0 ? 0 : (value & 7) == 1 ? 0x48 : (value & 15) == 3 ? 0x8B : (uint8_t)(value >> 8);
+        if (memory[idx] == 0xE8) memory[idx] = 0xE9;
+    }
+    memcpy(memory + BENCH_SIZE / 2 - 3, signature, sizeof(signature));
+
+    cr_assert(Pattern_compile(&pattern, "48 8B 05 ?? ?? ?? ?? E8"));
+
+    const double naive_start = bench_now();
+    cr_assert_eq(naive_scan(&pattern, (uintptr_t)memory, BENCH_SIZE), 1);
+    const double naive_time = bench_now() - naive_start;
+
+    for (size_t threads = 1; threads <= 4; threads *= 4) {
+        Process_scan_options options = {0};
+
+        options.threads = threads;
+        options.start = (uintptr_t)memory;
+        options.end = (uintptr_t)memory + BENCH_SIZE;
+
+        const double scan_start = bench_now();
+        cr_assert_eq(Process_scan(Process_self(), &pattern, &options, &match, 1), 1);
+        const double scan_time = bench_now() - scan_start;
+
+        cr_assert_eq(match, (uintptr_t)memory + BENCH_SIZE / 2 - 3);
+        cr_log_info("Process_scan with %u threads: %.0f MB/s", (unsigned)threads, BENCH_SIZE / scan_time / 1e6);
+    }
+
+    cr_log_info("naive loop: %.0f MB/s", BENCH_SIZE / naive_time / 1e6);
+
+    cr_assert(VirtualFree(memory, 0, MEM_RELEASE));
+}
@@ -0,0 +1,105 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+#define PAGES 4
+
+static uint8_t *pages = NULL;
+
+static void setup() {
+    pages = (uint8_t*)VirtualAlloc(NULL, PAGES * PROCESS_SEARCH_PAGE_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    cr_assert_not_null(pages);
+}
+
+static void teardown() {
+    VirtualFree(pages, 0, MEM_RELEASE);
+}
+
+TestSuite(process_search, .init = setup, .fini = teardown);
+
+static Process_search_options page_options(void) {
+    Process_search_options options = {0};
+
+    options.start = (uintptr_t)pages;
+    options.end = (uintptr_t)pages + PAGES * PROCESS_SEARCH_PAGE_SIZE;
+    return options;
+}
+
+/**
+ * Test narrowing of integers by operand and by previous values.
+ */
+Test(process_search, narrow_i32) {
+    int32_t *values = (int32_t*)pages;
+    const size_t len = PAGES * PROCESS_SEARCH_PAGE_SIZE / sizeof(*values);
+    const size_t last = (len - 1) / 7 * 7;
+    const Process_search_options options = page_options();
+    Process_search search;
+    Process_value operand = {.i32 = 100};
+    uintptr_t addresses[4];
+    Process_value found[4];
+
+    for (size_t idx = 0; idx < len; idx++) values[idx] = idx % 7 == 0 ? 100 : -(int32_t)idx;
+
+    cr_assert(Process_search_init(&search, Process_self(), PROCESS_VALUE_I32, &options));
+    cr_assert_not(Process_search_first(&search, PROCESS_SEARCH_CHANGED, operand), "Nothing to compare with on first pass");
+
+    cr_assert(Process_search_first(&search, PROCESS_SEARCH_EQUAL, operand));
+    cr_assert_eq(Process_search_count(&search), (len + 6) / 7);
+
+    values[7] = 99;
+    values[14] = 101;
+    values[last] = 50;
+
+    cr_assert(Process_search_next(&search, PROCESS_SEARCH_DECREASED, operand));
+    cr_assert_eq(Process_search_count(&search), 2);
+    cr_assert_eq(Process_search_get(&search, 0, addresses, found, 4), 2);
+    cr_assert_eq(addresses[0], (uintptr_t)&values[7]);
+    cr_assert_eq(found[0].i32, 99);
+    cr_assert_eq(addresses[1], (uintptr_t)&values[last]);
+    cr_assert_eq(found[1].i32, 50);
+
+    cr_assert_eq(Process_search_get(&search, 1, addresses, NULL, 4), 1);
+    cr_assert_eq(addresses[0], (uintptr_t)&values[last]);
+
+    cr_assert(Process_search_next(&search, PROCESS_SEARCH_UNCHANGED, operand));
+    cr_assert_eq(Process_search_count(&search), 2);
+
+    operand.i32 = 60;
+    cr_assert(Process_search_next(&search, PROCESS_SEARCH_GREATER, operand));
+    cr_assert_eq(Process_search_count(&search), 1);
+
+    Process_search_free(&search);
+}
+
+/**
+ * Test unaligned doubles and dropping of pages that cannot be read anymore.
+ */
+Test(process_search, unaligned_f64) {
+    Process_search_options options = page_options();
+    Process_search search;
+    Process_value operand = {.f64 = 2.5};
+    DWORD old_protect;
+    uintptr_t addresses[4];
+
+    memset(pages, 0, PAGES * PROCESS_SEARCH_PAGE_SIZE);
+    memcpy(pages + 3, &operand.f64, sizeof(operand.f64));
+    memcpy(pages + 3 * PROCESS_SEARCH_PAGE_SIZE + 101, &operand.f64, sizeof(operand.f64));
+
+    options.alignment = 1;
+    cr_assert(Process_search_init(&search, Process_self(), PROCESS_VALUE_F64, &options));
+
+    cr_assert(Process_search_first(&search, PROCESS_SEARCH_EQUAL, operand));
+    cr_assert_eq(Process_search_count(&search), 2);
+    cr_assert_eq(Process_search_get(&search, 0, addresses, NULL, 4), 2);
+    cr_assert_eq(addresses[0], (uintptr_t)pages + 3);
+    cr_assert_eq(addresses[1], (uintptr_t)pages + 3 * PROCESS_SEARCH_PAGE_SIZE + 101);
+
+    cr_assert(VirtualProtect(pages + 3 * PROCESS_SEARCH_PAGE_SIZE, PROCESS_SEARCH_PAGE_SIZE, PAGE_NOACCESS, &old_protect));
+    cr_assert(Process_search_next(&search, PROCESS_SEARCH_UNCHANGED, operand));
+    cr_assert_eq(Process_search_count(&search), 1);
+
+    Process_search_free(&search);
+
+    options.alignment = 3;
+    cr_assert_not(Process_search_init(&search, Process_self(), PROCESS_VALUE_F64, &options));
+}
@@ -0,0 +1,113 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+#define PAGES 8
+
+static const wchar_t before_path[] = L"process_snapshot_before.bin";
+static const wchar_t after_path[] = L"process_snapshot_after.bin";
+
+static uint8_t *pages = NULL;
+
+static void setup() {
+    pages = (uint8_t*)VirtualAlloc(NULL, PAGES * PROCESS_SNAPSHOT_PAGE_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    cr_assert_not_null(pages);
+}
+
+static void teardown() {
+    VirtualFree(pages, 0, MEM_RELEASE);
+    DeleteFileW(before_path);
+    DeleteFileW(after_path);
+}
+
+TestSuite(process_snapshot, .init = setup, .fini = teardown);
+
+static Process_snapshot_options page_options(void) {
+    Process_snapshot_options options = {0};
+
+    options.start = (uintptr_t)pages;
+    options.end = (uintptr_t)pages + PAGES * PROCESS_SNAPSHOT_PAGE_SIZE;
+    return options;
+}
+
+/**
+ * Test changes between snapshots and live memory.
+ */
+Test(process_snapshot, diff) {
+    const Process_snapshot_options options = page_options();
+    Process_snapshot before;
+    Process_snapshot after;
+    Process_snapshot_range ranges[4];
+    uint8_t buffer[16];
+
+    for (size_t idx = 0; idx < 4 * PROCESS_SNAPSHOT_PAGE_SIZE; idx++) pages[idx] = (uint8_t)(idx % 251 + 1);
+
+    cr_assert(Process_snapshot_take(Process_self(), before_path, &options));
+    cr_assert(Process_snapshot_open(&before, before_path));
+    cr_assert_eq(before.regions_len, 1);
+    cr_assert_eq(before.regions[0].base, (uintptr_t)pages);
+    cr_assert_eq(before.regions[0].size, PAGES * PROCESS_SNAPSHOT_PAGE_SIZE);
+    cr_assert_eq(before.data_pages, 4, "Zero pages are not stored");
+
+    cr_assert(Process_snapshot_read(&before, (uintptr_t)pages + 4 * PROCESS_SNAPSHOT_PAGE_SIZE - 8, buffer, sizeof(buffer)));
+    cr_assert_arr_eq(buffer, pages + 4 * PROCESS_SNAPSHOT_PAGE_SIZE - 8, sizeof(buffer));
+    cr_assert_not(Process_snapshot_read(&before, (uintptr_t)pages + PAGES * PROCESS_SNAPSHOT_PAGE_SIZE - 8, buffer, sizeof(buffer)));
+
+    cr_assert_eq(Process_snapshot_diff_live(&before, Process_self(), ranges, 4), 0);
+
+    memset(pages + PROCESS_SNAPSHOT_PAGE_SIZE + 10, 0xFF, 4);
+    pages[4 * PROCESS_SNAPSHOT_PAGE_SIZE - 1] = 0;
+    pages[4 * PROCESS_SNAPSHOT_PAGE_SIZE] = 1;
+    pages[6 * PROCESS_SNAPSHOT_PAGE_SIZE + 100] = 1;
+
+    cr_assert_eq(Process_snapshot_diff_live(&before, Process_self(), ranges, 4), 3);
+    cr_assert_eq(ranges[0].base, (uintptr_t)pages + PROCESS_SNAPSHOT_PAGE_SIZE + 10);
+    cr_assert_eq(ranges[0].size, 4);
+    cr_assert_eq(ranges[1].base, (uintptr_t)pages + 4 * PROCESS_SNAPSHOT_PAGE_SIZE - 1);
+    cr_assert_eq(ranges[1].size, 2, "Changes across pages are merged");
+    cr_assert_eq(ranges[2].base, (uintptr_t)pages + 6 * PROCESS_SNAPSHOT_PAGE_SIZE + 100);
+    cr_assert_eq(ranges[2].size, 1);
+
+    cr_assert(Process_snapshot_take(Process_self(), after_path, &options));
+    cr_assert(Process_snapshot_open(&after, after_path));
+
+    cr_assert_eq(Process_snapshot_diff(&before, &after, ranges, 1), 3);
+    cr_assert_eq(ranges[0].base, (uintptr_t)pages + PROCESS_SNAPSHOT_PAGE_SIZE + 10);
+    cr_assert_eq(ranges[0].size, 4);
+    cr_assert_eq(Process_snapshot_diff(&after, &after, ranges, 4), 0);
+
+    Process_snapshot_close(&after);
+    Process_snapshot_close(&before);
+}
+
+/**
+ * Test pages that are captured by only one of snapshots.
+ */
+Test(process_snapshot, unreadable) {
+    const Process_snapshot_options options = page_options();
+    Process_snapshot before;
+    Process_snapshot after;
+    Process_snapshot_range ranges[4];
+    DWORD old_protect;
+
+    memset(pages, 1, PAGES * PROCESS_SNAPSHOT_PAGE_SIZE);
+
+    cr_assert(VirtualProtect(pages + 2 * PROCESS_SNAPSHOT_PAGE_SIZE, PROCESS_SNAPSHOT_PAGE_SIZE, PAGE_NOACCESS, &old_protect));
+    cr_assert(Process_snapshot_take(Process_self(), before_path, &options));
+    cr_assert(VirtualProtect(pages + 2 * PROCESS_SNAPSHOT_PAGE_SIZE, PROCESS_SNAPSHOT_PAGE_SIZE, PAGE_READWRITE, &old_protect));
+    cr_assert(Process_snapshot_take(Process_self(), after_path, &options));
+
+    cr_assert(Process_snapshot_open(&before, before_path));
+    cr_assert(Process_snapshot_open(&after, after_path));
+
+    cr_assert_eq(Process_snapshot_diff_live(&before, Process_self(), ranges, 4), 0, "Memory that is not captured is not compared");
+
+    cr_assert_eq(Process_snapshot_diff(&before, &after, ranges, 4), 1);
+    cr_assert_eq(ranges[0].base, (uintptr_t)pages + 2 * PROCESS_SNAPSHOT_PAGE_SIZE);
+    cr_assert_eq(ranges[0].size, PROCESS_SNAPSHOT_PAGE_SIZE);
+
+    Process_snapshot_close(&after);
+    Process_snapshot_close(&before);
+
+    cr_assert_not(Process_snapshot_open(&before, L"process_snapshot_missing.bin"));
+}
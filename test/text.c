@@ -0,0 +1,196 @@
+#include <criterion/criterion.h>
+
+#include "lazy_winapi.h"
+
+/**
+ * Test conversion of UTF-8 into UTF-16 and back.
+ */
+Test(text, utf8_round_trip) {
+    /* "Aя€😀" */
+    const char text[] = "A\xD1\x8F\xE2\x82\xAC\xF0\x9F\x98\x80";
+    const uint16_t expected[] = {0x41, 0x44F, 0x20AC, 0xD83D, 0xDE00};
+    const size_t text_len = sizeof(text) - 1;
+    const size_t expected_len = sizeof(expected) / sizeof(expected[0]);
+    uint16_t wide_text[16] = {0};
+    char back[16] = {0};
+
+    cr_assert_eq(Text_utf8_to_utf16(text, text_len, NULL, 0), expected_len);
+    cr_assert_eq(Text_utf8_to_utf16(text, text_len, wide_text, 16), expected_len);
+    cr_assert_arr_eq(wide_text, expected, sizeof(expected));
+
+    cr_assert_eq(Text_utf16_to_utf8(wide_text, expected_len, NULL, 0), text_len);
+    cr_assert_eq(Text_utf16_to_utf8(wide_text, expected_len, back, 16), text_len);
+    cr_assert_arr_eq(back, text, text_len);
+}
+
+/**
+ * Test conversion of long ASCII text that goes through vectorized path.
+ */
+Test(text, ascii_long) {
+    char text[1000];
+    uint16_t wide_text[1000];
+    char back[1000];
+
+    for (size_t idx = 0; idx < sizeof(text); idx++) text[idx] = (char)('a' + idx % 26);
+    /* Break ASCII run in the middle. */
+    text[500] = (char)0xC3;
+    text[501] = (char)0xA9;
+
+    const size_t wide_len = Text_utf8_to_utf16(text, sizeof(text), wide_text, 1000);
+    cr_assert_eq(wide_len, sizeof(text) - 1);
+    cr_assert_eq(wide_text[499], (uint16_t)'a' + 499 % 26);
+    cr_assert_eq(wide_text[500], 0xE9);
+    cr_assert_eq(wide_text[998], (uint16_t)'a' + 999 % 26);
+
+    cr_assert_eq(Text_utf16_to_utf8(wide_text, wide_len, back, sizeof(back)), sizeof(text));
+    cr_assert_arr_eq(back, text, sizeof(text));
+}
+
+/**
+ * Test replacement of invalid input.
+ */
+Test(text, invalid) {
+    const uint16_t lone_surrogate[] = {0x41, 0xD800, 0x42};
+    uint16_t wide_text[8] = {0};
+    char text[8] = {0};
+
+    cr_assert_eq(Text_utf8_to_utf16("\xE0\x80\x80", 3, wide_text, 8), 3, "Overlong form should be rejected");
+    cr_assert_eq(wide_text[0], 0xFFFD);
+    cr_assert_eq(Text_utf8_to_utf16("\xF0\x9F\x98", 3, wide_text, 8), 1, "Truncated sequence is single replacement");
+    cr_assert_eq(wide_text[0], 0xFFFD);
+
+    cr_assert_eq(Text_utf16_to_utf8(lone_surrogate, 3, text, 8), 5);
+    cr_assert_arr_eq(text, "A\xEF\xBF\xBD" "B", 5);
+}
+
+/**
+ * Test that conversion does not split code points on truncation.
+ */
+Test(text, truncation) {
+    const char text[] = "A\xF0\x9F\x98\x80";
+    const uint16_t wide_text[] = {0x41, 0xD83D, 0xDE00};
+    uint16_t wide_out[2] = {0};
+    char out[4] = {0};
+
+    cr_assert_eq(Text_utf8_to_utf16(text, sizeof(text) - 1, wide_out, 2), 1, "Surrogate pair shouldn't be split");
+    cr_assert_eq(Text_utf16_to_utf8(wide_text, 3, out, 4), 1, "UTF-8 sequence shouldn't be split");
+}
+
+/**
+ * Test conversion of line endings.
+ */
+Test(text, newline) {
+    const char lf_text[] = "\nFor\nmy\r\nwaifu!\r";
+    const char crlf_text[] = "\r\nFor\r\nmy\r\nwaifu!\r";
+    const char back_text[] = "\nFor\nmy\nwaifu!\r";
+    char out[32] = {0};
+
+    cr_assert_eq(Text_lf_to_crlf(lf_text, sizeof(lf_text) - 1, NULL, 0), sizeof(crlf_text) - 1);
+    cr_assert_eq(Text_lf_to_crlf(lf_text, sizeof(lf_text) - 1, out, sizeof(out)), sizeof(crlf_text) - 1);
+    cr_assert_arr_eq(out, crlf_text, sizeof(crlf_text) - 1);
+
+    cr_assert_eq(Text_crlf_to_lf(crlf_text, sizeof(crlf_text) - 1, NULL, 0), sizeof(back_text) - 1);
+    cr_assert_eq(Text_crlf_to_lf(crlf_text, sizeof(crlf_text) - 1, out, sizeof(out)), sizeof(back_text) - 1);
+    cr_assert_arr_eq(out, back_text, sizeof(back_text) - 1);
+
+    cr_assert_eq(Text_lf_to_crlf(lf_text, sizeof(lf_text) - 1, out, 1), 0, "CRLF shouldn't be split");
+}
+
+/**
+ * Test conversion of line endings in long UTF-16 text that goes through vectorized path.
+ */
+Test(text, newline_utf16_long) {
+    uint16_t text[1000];
+    uint16_t crlf_text[1100];
+    uint16_t back[1100];
+    size_t lines = 0;
+
+    for (size_t idx = 0; idx < 1000; idx++) {
+        text[idx] = idx % 37 == 36 ? '\n' : (uint16_t)(0x430 + idx % 32);
+        if (text[idx] == '\n') lines++;
+    }
+
+    const size_t crlf_len = Text_lf_to_crlf_utf16(text, 1000, crlf_text, 1100);
+    cr_assert_eq(crlf_len, 1000 + lines);
+    cr_assert_eq(Text_lf_to_crlf_utf16(text, 1000, NULL, 0), crlf_len);
+    cr_assert_eq(crlf_text[36], '\r');
+    cr_assert_eq(crlf_text[37], '\n');
+
+    cr_assert_eq(Text_crlf_to_lf_utf16(crlf_text, crlf_len, back, 1100), 1000);
+    cr_assert_arr_eq(back, text, sizeof(text));
+}
+
+#define BENCH_SIZE (8 * 1024 * 1024)
+#define BENCH_ROUNDS 10
+
+/**
+ * @return Current time in seconds.
+ */
+static double bench_now() {
+    LARGE_INTEGER frequency, counter;
+
+    (void)QueryPerformanceFrequency(&frequency);
+    (void)QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+/**
+ * Measures conversion of text in both directions.
+ *
+ * @param[in] name Kind of text to log.
+ */
+static void bench_round_trip(const char *name, const char *text, size_t text_len) {
+    const size_t wide_len = Text_utf8_to_utf16(text, text_len, NULL, 0);
+    uint16_t *wide_text = (uint16_t*)malloc(wide_len * sizeof(*wide_text));
+    char *back = (char*)malloc(text_len);
+
+    cr_assert_not_null(wide_text);
+    cr_assert_not_null(back);
+
+    const double to_utf16_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(Text_utf8_to_utf16(text, text_len, wide_text, wide_len), wide_len);
+    }
+    const double to_utf16_time = bench_now() - to_utf16_start;
+
+    const double to_utf8_start = bench_now();
+    for (size_t idx = 0; idx < BENCH_ROUNDS; idx++) {
+        cr_assert_eq(Text_utf16_to_utf8(wide_text, wide_len, back, text_len), text_len);
+    }
+    const double to_utf8_time = bench_now() - to_utf8_start;
+
+    cr_assert_arr_eq(back, text, text_len);
+    cr_log_info("%s: UTF-8 to UTF-16 %.0f MB/s, UTF-16 to UTF-8 %.0f MB/s", name,
+                (double)text_len * BENCH_ROUNDS / to_utf16_time / 1e6,
+                (double)text_len * BENCH_ROUNDS / to_utf8_time / 1e6);
+
+    free(wide_text);
+    free(back);
+}
+
+/**
+ * Measures throughput of conversion on multi-megabyte texts.
+ */
+Test(text, bench_transcode) {
+    /* Line of English words and line of Russian words, "привет мир". */
+    const char *lines[] = {"lorem ipsum dolor sit amet consectetur\n", "\xD0\xBF\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xD0\xBC\xD0\xB8\xD1\x80\n"};
+    char *text = (char*)malloc(BENCH_SIZE);
+    size_t text_len = 0;
+
+    cr_assert_not_null(text);
+
+    while (text_len + strlen(lines[0]) <= BENCH_SIZE) {
+        memcpy(text + text_len, lines[0], strlen(lines[0]));
+        text_len += strlen(lines[0]);
+    }
+    bench_round_trip("ASCII", text, text_len);
+
+    text_len = 0;
+    for (size_t line = 0; text_len + strlen(lines[line % 2]) <= BENCH_SIZE; line++) {
+        memcpy(text + text_len, lines[line % 2], strlen(lines[line % 2]));
+        text_len += strlen(lines[line % 2]);
+    }
+    bench_round_trip("mixed", text, text_len);
+
+    free(text);
+}